@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_BENCH_H_
+#define OKEC_BENCH_H_
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+
+namespace okec::bench
+{
+
+struct options {
+    std::string filter;            // 只运行名称包含 filter 的基准
+    double min_time = 0.5;         // seconds per micro benchmark
+    std::vector<int> scales = { 1, 4, 16 }; // macro scenario scale factors
+};
+
+inline auto selected(const options& opts, std::string_view name) -> bool {
+    return opts.filter.empty() || name.find(opts.filter) != std::string_view::npos;
+}
+
+template <class T>
+inline auto do_not_optimize(const T& value) -> void {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline auto elapsed_since(std::chrono::steady_clock::time_point start) -> double {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Calls body(n) with a growing iteration count until one call takes at
+// least min_time, then reports that call.
+template <class F>
+auto measure(std::string name, json params, double min_time, F&& body) -> json {
+    std::size_t n = 1;
+    for (;;) {
+        auto start = std::chrono::steady_clock::now();
+        body(n);
+        double seconds = elapsed_since(start);
+
+        if (seconds >= min_time || n >= (std::size_t{1} << 40)) {
+            return {
+                { "name", std::move(name) },
+                { "kind", "micro" },
+                { "params", std::move(params) },
+                { "iterations", n },
+                { "seconds", seconds },
+                { "ns_per_op", seconds * 1e9 / n },
+                { "ops_per_second", n / seconds }
+            };
+        }
+
+        // 按本轮耗时估算，每轮最多放大 100 倍
+        auto estimate = seconds > 0 ? static_cast<std::size_t>(n * min_time / seconds * 1.2) : n * 100;
+        n = std::clamp(estimate, n * 2, n * 100);
+    }
+}
+
+auto micro_benchmarks(const options& opts) -> std::vector<json>;
+auto macro_benchmarks(const options& opts) -> std::vector<json>;
+
+} // namespace okec::bench
+
+#endif // OKEC_BENCH_H_
@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+#include <okec/okec.hpp>
+
+
+namespace okec::bench
+{
+
+namespace {
+
+auto generate_task(task& t, int number, double size_min, double size_max) -> void
+{
+    for (auto i = number; i-- > 0;) {
+        t.emplace_back({
+            { "task_id", task::unique_id() },
+            { "group", "bench" },
+            { "size", rand_range(size_min, size_max).to_string() },
+            { "cpu", rand_range(0.2, 1.2).to_string() },
+            { "deadline", rand_range(2.0, 2.5).to_string() }
+        });
+    }
+}
+
+// 运行仿真并统计事件数与墙钟时间
+auto run_simulation(simulator& sim, double horizon) -> json
+{
+    sim.stop_time(ns3::Seconds(horizon));
+
+    auto start = std::chrono::steady_clock::now();
+    sim.run();
+    double seconds = elapsed_since(start);
+
+    double simulated = ns3::Simulator::Now().GetSeconds();
+    auto events = ns3::Simulator::GetEventCount();
+    return {
+        { "events", events },
+        { "wall_seconds", seconds },
+        { "simulated_seconds", simulated },
+        { "events_per_second", events / seconds },
+        { "wall_seconds_per_simulated_second", simulated > 0 ? seconds / simulated : 0.0 }
+    };
+}
+
+// worst-fit over a WLAN + LAN topology, as in examples/src/wf_net.cc
+auto wlan_scenario(const experiment_runner::run_info& info) -> json
+{
+    auto scale = info.params["scale"].get<int>();
+    auto horizon = info.params["horizon"].get<double>();
+    auto batch = info.params["batch"].get<std::size_t>();
+
+    simulator sim;
+    base_station_container bs(sim, 1);
+    edge_device_container edge_servers(sim, 5 * scale);
+    client_device_container user_devices(sim, 2);
+    bs.connect_device(edge_servers);
+
+    multiple_and_single_LAN_WLAN_network_model model;
+    network_initializer(model, user_devices, bs.get(0));
+
+    resource_container resources(edge_servers.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", rand_range(2.1, 2.2).to_string());
+    });
+    edge_servers.install_resources(resources);
+
+    auto engine = std::make_shared<worst_fit_decision_engine>(&user_devices, &bs);
+    engine->set_batch_size(batch);
+    engine->initialize();
+
+    std::size_t responses = 0;
+    auto user = user_devices.get_device(0);
+    user->async_read([&responses](const response& r) {
+        responses += r.size();
+    });
+
+    task t;
+    generate_task(t, 50 * scale, 0.5, 1.0);
+    user->send(t);
+
+    auto result = run_simulation(sim, horizon);
+    result["tasks"] = t.size();
+    result["responses"] = responses;
+    result["conflicts"] = engine->stats().conflicts;
+    result["retries"] = engine->stats().retries;
+    result["wasted_bytes"] = engine->stats().wasted_bytes;
+    return result;
+}
+
+// default cloud-edge-end policy, as in examples/src/seventh.cc
+auto cloud_edge_end_scenario(const experiment_runner::run_info& info) -> json
+{
+    auto scale = info.params["scale"].get<int>();
+    auto horizon = info.params["horizon"].get<double>();
+    auto batch = info.params["batch"].get<std::size_t>();
+
+    simulator sim;
+    base_station_container bs(sim, 1);
+    edge_device_container edge_servers(sim, 3 * scale);
+    client_device_container user_devices(sim, 2);
+    cloud_server cloud(sim);
+    bs.connect_device(edge_servers);
+
+    cloud_edge_end_model model;
+    network_initializer(model, user_devices, bs.get(0), cloud);
+    bs.get(0)->set_position(0, 0, 0);
+    cloud.set_position(100, 0, 0);
+
+    resource_container resources(edge_servers.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", rand_range(2.4, 2.8).to_string());
+    });
+    edge_servers.install_resources(resources);
+
+    auto cloud_res = make_resource();
+    cloud_res->attribute("cpu", "20");
+    cloud.install_resource(cloud_res);
+
+    auto engine = std::make_shared<cloud_edge_end_default_decision_engine>(&user_devices, &bs, &cloud);
+    engine->set_batch_size(batch);
+    engine->initialize();
+
+    std::size_t responses = 0;
+    auto user = user_devices.get_device(0);
+    user->async_read([&responses](const response& r) {
+        responses += r.size();
+    });
+
+    task t;
+    generate_task(t, 10 * scale, 20, 25);
+    user->send(t);
+
+    auto result = run_simulation(sim, horizon);
+    result["tasks"] = t.size();
+    result["responses"] = responses;
+    result["conflicts"] = engine->stats().conflicts;
+    result["retries"] = engine->stats().retries;
+    result["wasted_bytes"] = engine->stats().wasted_bytes;
+    return result;
+}
+
+auto run_scenario(const options& opts, std::string name, experiment_runner::scenario_type scenario,
+    std::vector<json>& results) -> void
+{
+    if (!selected(opts, name))
+        return;
+
+    parameter_grid grid;
+    std::vector<json> scales(opts.scales.begin(), opts.scales.end());
+    grid.add("scale", std::move(scales))
+        .add("horizon", { 300.0 })
+        .add("batch", { 1, 8 });
+
+    // 逐个运行，避免并行的仿真相互影响计时
+    experiment_runner runner(std::move(scenario));
+    runner.workers(1).seed(2024).on_result([&](const auto& info, const json& result) {
+        json item = { { "name", name }, { "kind", "macro" }, { "params", info.params } };
+        item.update(result);
+        results.push_back(std::move(item));
+    });
+    runner.run(grid);
+}
+
+} // namespace
+
+auto macro_benchmarks(const options& opts) -> std::vector<json>
+{
+    std::vector<json> results;
+    run_scenario(opts, "scenario/multiple_and_single_LAN_WLAN", wlan_scenario, results);
+    run_scenario(opts, "scenario/cloud_edge_end", cloud_edge_end_scenario, results);
+    return results;
+}
+
+} // namespace okec::bench
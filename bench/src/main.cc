@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+#include <okec/utils/format_helper.hpp>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <ranges>
+#include <string>
+
+namespace bench = okec::bench;
+
+
+// okec_bench [--filter <substr>] [--min-time <seconds>] [--scales 1,4,16]
+//            [--no-micro] [--no-macro] [--out <file>]
+int main(int argc, char **argv)
+{
+    bench::options opts;
+    std::string out;
+    bool micro = true;
+    bool macro = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                okec::print("missing value for {}\n", arg);
+                std::exit(EXIT_FAILURE);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--filter") {
+            opts.filter = value();
+        } else if (arg == "--min-time") {
+            opts.min_time = std::stod(value());
+        } else if (arg == "--scales") {
+            opts.scales.clear();
+            for (auto part : std::views::split(value(), ','))
+                opts.scales.push_back(std::stoi(std::string(part.begin(), part.end())));
+        } else if (arg == "--no-micro") {
+            micro = false;
+        } else if (arg == "--no-macro") {
+            macro = false;
+        } else if (arg == "--out") {
+            out = value();
+        } else {
+            okec::print("unknown option: {}\n", arg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    json report = {
+        { "okec_version", OKEC_VERSION },
+        { "timestamp", std::time(nullptr) },
+        { "min_time", opts.min_time },
+        { "benchmarks", json::array() }
+    };
+
+    auto append = [&report](std::vector<json> results) {
+        for (auto& item : results)
+            report["benchmarks"].push_back(std::move(item));
+    };
+
+    if (micro)
+        append(bench::micro_benchmarks(opts));
+    if (macro)
+        append(bench::macro_benchmarks(opts));
+
+    if (out.empty()) {
+        std::cout << report.dump(2) << "\n";
+    } else {
+        std::ofstream file(out);
+        file << report.dump(2) << "\n";
+    }
+}
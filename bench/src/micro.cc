@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+#include <okec/okec.hpp>
+#include <random>
+
+
+namespace okec::bench
+{
+
+namespace {
+
+auto make_tasks(std::size_t count, std::mt19937& rng) -> task
+{
+    std::uniform_real_distribution<double> cpu(0.2, 1.2);
+    std::uniform_real_distribution<double> size(20, 25);
+
+    task t;
+    for (std::size_t i = 0; i < count; ++i) {
+        t.emplace_back({
+            { "task_id", task::unique_id() },
+            { "group", "bench" },
+            { "size", okec::format("{:.2f}", size(rng)) },
+            { "cpu", okec::format("{:.2f}", cpu(rng)) },
+            { "deadline", "2.5" }
+        });
+    }
+    return t;
+}
+
+// 在决策引擎的设备表中直接添加 count 个边缘服务器和一个云
+auto populate(decision_engine& engine, std::size_t count, std::mt19937& rng) -> void
+{
+    std::uniform_real_distribution<double> cpu(2.0, 3.0);
+
+    auto& cache = engine.cache();
+    cache.track("cpu");
+    cache.track("cpu", "es");
+    for (std::size_t i = 0; i < count; ++i) {
+        auto index = cache.emplace("es", ns3::Ipv4Address(0x0A000001 + i), 8860, { 10.0, 0.0, 0.0 });
+        cache.set(index, "cpu", cpu(rng));
+    }
+
+    auto cs = cache.emplace("cs", ns3::Ipv4Address(0x0B000001), 8860, { 100.0, 0.0, 0.0 });
+    cache.set(cs, "cpu", 20.0);
+}
+
+auto bench_message(const options& opts, std::vector<json>& results) -> void
+{
+    std::mt19937 rng(42);
+    auto t = make_tasks(1, rng);
+    auto item = t.at(0);
+    item.set_header("from_ip", "10.1.1.2");
+    item.set_header("from_port", "8860");
+
+    for (auto fmt : { wire::format::binary, wire::format::json }) {
+        packet_helper::set_wire_format(fmt);
+        json params = { { "format", fmt == wire::format::binary ? "binary" : "json" } };
+
+        auto make_message = [&item] {
+            message msg;
+            msg.type(message_handling);
+            msg.content(item);
+            msg.attribute("cpu_supply", "2.5");
+            return msg;
+        };
+
+        if (selected(opts, "message/encode")) {
+            results.push_back(measure("message/encode", params, opts.min_time, [&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i)
+                    do_not_optimize(make_message().to_packet());
+            }));
+        }
+
+        if (selected(opts, "message/decode")) {
+            auto packet = make_message().to_packet();
+            results.push_back(measure("message/decode", params, opts.min_time, [&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto msg = message::from_packet(packet);
+                    do_not_optimize(msg.get_task_element());
+                }
+            }));
+        }
+    }
+
+    packet_helper::set_wire_format(wire::format::binary);
+}
+
+auto bench_task(const options& opts, std::vector<json>& results) -> void
+{
+    if (selected(opts, "task/emplace_back")) {
+        results.push_back(measure("task/emplace_back", {}, opts.min_time, [](std::size_t n) {
+            task t;
+            for (std::size_t i = 0; i < n; ++i) {
+                t.emplace_back({
+                    { "task_id", "0123456789abcdef0123456789abcdef" },
+                    { "group", "bench" },
+                    { "size", "20.5" },
+                    { "cpu", "0.8" },
+                    { "deadline", "2.5" }
+                });
+            }
+            do_not_optimize(t.size());
+        }));
+    }
+
+    if (selected(opts, "task/elements_view")) {
+        std::mt19937 rng(42);
+        for (std::size_t rows : { 100uz, 10000uz }) {
+            auto t = make_tasks(rows, rng);
+            results.push_back(measure("task/elements_view", { { "rows", rows } }, opts.min_time, [&t](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i)
+                    do_not_optimize(t.elements_view().size());
+            }));
+        }
+    }
+}
+
+auto bench_device_cache(const options& opts, std::vector<json>& results) -> void
+{
+    if (!selected(opts, "device_cache/set"))
+        return;
+
+    for (std::size_t devices : { 10uz, 1000uz, 100000uz }) {
+        std::mt19937 rng(42);
+        worst_fit_decision_engine engine;
+        populate(engine, devices, rng);
+        auto& cache = engine.cache();
+
+        // 预先生成随机的更新序列，避免计时包含随机数生成
+        std::uniform_int_distribution<std::size_t> pick(0, devices - 1);
+        std::uniform_real_distribution<double> value(0.0, 3.0);
+        std::vector<std::pair<std::size_t, double>> updates(4096);
+        for (auto& [index, v] : updates)
+            v = value(rng), index = pick(rng);
+
+        results.push_back(measure("device_cache/set", { { "devices", devices } }, opts.min_time, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& [index, v] = updates[i % updates.size()];
+                cache.set(index, "cpu", v);
+            }
+        }));
+    }
+}
+
+template <class Engine>
+auto bench_make_decision(const options& opts, std::string_view engine_name, std::vector<json>& results) -> void
+{
+    if (!selected(opts, "make_decision"))
+        return;
+
+    for (std::size_t devices : { 10uz, 100uz, 1000uz, 10000uz }) {
+        std::mt19937 rng(42);
+        auto engine = std::make_shared<Engine>();
+        populate(*engine, devices, rng);
+
+        auto t = make_tasks(256, rng);
+        for (auto&& item : t.elements_view()) {
+            item.set_header("arrival_time", "0");
+            item.set_header("transmission_delay", "0.1");
+        }
+        auto items = t.elements_view();
+
+        json params = { { "engine", engine_name }, { "devices", devices } };
+        results.push_back(measure("make_decision", params, opts.min_time, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                do_not_optimize(engine->make_decision(items[i % items.size()]));
+        }));
+    }
+}
+
+// handle_next 需要真实的基站设备，放到独立进程中运行
+auto bench_handle_next(const options& opts, std::vector<json>& results) -> void
+{
+    if (!selected(opts, "handle_next"))
+        return;
+
+    experiment_runner runner([](const experiment_runner::run_info& info) -> json {
+        auto tasks = info.params["tasks"].get<std::size_t>();
+
+        simulator sim;
+        base_station_container bs(sim, 1);
+        edge_device_container edge_servers(sim, 20);
+        client_device_container user_devices(sim, 2);
+        bs.connect_device(edge_servers);
+
+        multiple_and_single_LAN_WLAN_network_model model;
+        network_initializer(model, user_devices, bs.get(0));
+
+        // 每台设备都能容纳全部任务，每次调用都走分发路径而不是资源不足的提前返回
+        resource_container resources(edge_servers.size());
+        resources.initialize([tasks](auto res) {
+            res->attribute("cpu", std::to_string(tasks * 2));
+        });
+        edge_servers.install_resources(resources);
+
+        auto engine = std::make_shared<worst_fit_decision_engine>(&user_devices, &bs);
+        engine->initialize();
+
+        std::mt19937 rng(info.seed);
+        auto t = make_tasks(tasks, rng);
+        auto& queue = bs.get(0)->task_sequence();
+        for (const auto& item : t.elements())
+            bs.get(0)->task_sequence(item);
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < tasks; ++i)
+            engine->handle_next();
+        double seconds = elapsed_since(start);
+
+        // 只按实际分发的任务计算
+        auto dispatched = std::max<std::size_t>(queue.in_flight_size(), 1);
+        return {
+            { "iterations", tasks },
+            { "dispatched", queue.in_flight_size() },
+            { "seconds", seconds },
+            { "ns_per_op", seconds * 1e9 / dispatched },
+            { "ops_per_second", dispatched / seconds }
+        };
+    });
+
+    parameter_grid grid;
+    grid.add("tasks", { 10000 });
+
+    runner.workers(1).on_result([&results](const auto& info, const json& result) {
+        json item = { { "name", "handle_next" }, { "kind", "micro" }, { "params", info.params } };
+        item.update(result);
+        results.push_back(std::move(item));
+    });
+    runner.run(grid);
+}
+
+} // namespace
+
+auto micro_benchmarks(const options& opts) -> std::vector<json>
+{
+    std::vector<json> results;
+    bench_message(opts, results);
+    bench_task(opts, results);
+    bench_device_cache(opts, results);
+    bench_make_decision<worst_fit_decision_engine>(opts, "worst_fit", results);
+    bench_make_decision<cloud_edge_end_default_decision_engine>(opts, "cloud_edge_end", results);
+    bench_make_decision<best_fit_decision_engine>(opts, "best_fit", results);
+    bench_make_decision<power_of_d_decision_engine>(opts, "power_of_d", results);
+    bench_handle_next(opts, results);
+    return results;
+}
+
+} // namespace okec::bench
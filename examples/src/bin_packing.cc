@@ -0,0 +1,65 @@
+#include <okec/okec.hpp>
+
+namespace olog = okec::log;
+
+
+// Tasks need memory and bandwidth as well as cpu
+void generate_task(okec::task& t, int number, const std::string& group) {
+    for ([[maybe_unused]] auto _ : std::views::iota(0, number)) {
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", group },
+            { "cpu", okec::rand_range(0.2, 1.2).to_string() },
+            { "memory", okec::rand_range(128, 1024).to_string() },
+            { "bandwidth", okec::rand_range(5, 20).to_string() },
+            { "deadline", okec::rand_range(10, 100).to_string() }
+        });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t task_num = 50;
+
+    ns3::CommandLine cmd;
+    cmd.AddValue("task_num", "number of tasks", task_num);
+    cmd.Parse(argc, argv);
+
+    olog::set_level(olog::level::success);
+
+    okec::simulator sim;
+
+    okec::base_station_container bs(sim, 1);
+    okec::edge_device_container edge_servers(sim, 5);
+    okec::client_device_container user_devices(sim, 2);
+    bs.connect_device(edge_servers);
+
+    okec::multiple_and_single_LAN_WLAN_network_model model;
+    okec::network_initializer(model, user_devices, bs.get(0));
+
+    // Every attribute declared here becomes a dimension of the packing
+    okec::resource_container resources(edge_servers.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", okec::rand_range(2.1, 2.2).to_string());
+        res->attribute("memory", okec::rand_range(2048, 4096).to_string());
+        res->attribute("bandwidth", okec::rand_range(50, 100).to_string());
+    });
+    edge_servers.install_resources(resources);
+
+    auto decision_engine = std::make_shared<okec::dot_product_decision_engine>(&user_devices, &bs);
+    decision_engine->initialize();
+
+    auto user = user_devices.get_device(0);
+    user->async_read([](okec::response resp) {
+        okec::print("{:r}", resp);
+    });
+
+    okec::task t;
+    generate_task(t, task_num, "bin-packing");
+    user->send(t);
+
+    sim.run();
+
+    auto stats = decision_engine->stats();
+    okec::print("dispatched: {}, conflicts: {}, retries: {}\n", stats.dispatched, stats.conflicts, stats.retries);
+}
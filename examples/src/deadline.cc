@@ -0,0 +1,83 @@
+#include <okec/okec.hpp>
+
+namespace olog = okec::log;
+
+
+void generate_task(okec::task& t, int number, std::string const& group)
+{
+    for (auto i = number; i-- > 0;) {
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", group },
+            { "size",  okec::rand_range(20, 25).to_string() },
+            { "cpu", okec::rand_range(0.5, 1.5).to_string() },
+            { "deadline", okec::rand_range(2.0, 2.5).to_string() },
+        });
+    }
+}
+
+okec::awaitable fetch(auto user, okec::completion_token token, std::string name) {
+    auto resp = co_await user->async_read(token);
+    double finished = 0;
+    for (const auto& item : resp.data()) {
+        if (item["finished"] == "Y") {
+            finished++;
+        }
+    }
+    olog::success("group {} completed: {:2.0f}%", name, finished / resp.size() * 100);
+}
+
+okec::awaitable offloading(auto user) {
+    okec::task first, second, third;
+    generate_task(first, 5, "first");
+    generate_task(second, 5, "second");
+    generate_task(third, 20, "third");
+
+    // 同时发出三组任务
+    auto t1 = co_await user->async_send(std::move(first));
+    auto t2 = co_await user->async_send(std::move(second));
+    auto t3 = co_await user->async_send(std::move(third));
+
+    // 先完成的一组先处理，另一组不再等待
+    auto index = co_await okec::when_any(fetch(user, t1, "first"), fetch(user, t2, "second"));
+    olog::info("group {} came back first", index == 0 ? "first" : "second");
+
+    // 有截止时间的卸载
+    if (!co_await okec::with_timeout(fetch(user, t3, "third"), ns3::Seconds(3)))
+        olog::warning("group third missed its deadline at {:.3f}s", okec::now::seconds());
+}
+
+int main(int argc, char **argv)
+{
+    olog::set_level(olog::level::info | olog::level::success | olog::level::warning);
+
+    okec::simulator sim;
+
+    okec::base_station_container base_stations(sim, 1);
+    okec::edge_device_container edge_servers(sim, 5);
+    okec::client_device_container user_devices(sim, 2);
+    okec::cloud_server cloud(sim);
+    base_stations.connect_device(edge_servers);
+
+    okec::cloud_edge_end_model model;
+    okec::network_initializer(model, user_devices, base_stations.get(0), cloud);
+    base_stations.get(0)->set_position(0, 0, 0);
+    cloud.set_position(100, 0, 0);
+
+    okec::resource_container resources(edge_servers.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", okec::rand_range(2.4, 2.8).to_string());
+    });
+    edge_servers.install_resources(resources);
+
+    auto cloud_res = okec::make_resource();
+    cloud_res->attribute("cpu", "20");
+    cloud.install_resource(cloud_res);
+
+    auto decision_engine = std::make_shared<okec::cloud_edge_end_default_decision_engine>(&user_devices, &base_stations, &cloud);
+    decision_engine->initialize();
+
+    co_spawn(sim, offloading(user_devices.get_device(0)));
+
+    sim.run();
+}
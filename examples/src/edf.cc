@@ -0,0 +1,72 @@
+#include <okec/okec.hpp>
+
+namespace olog = okec::log;
+
+
+void generate_task(okec::task& t, int number, const std::string& group) {
+    for ([[maybe_unused]] auto _ : std::views::iota(0, number)) {
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", group },
+            { "cpu", okec::rand_range(0.5, 1.5).to_string() },
+            { "deadline", okec::rand_range(0.5, 5.0).to_string() }
+        });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t task_num = 200;
+    bool admission = true;
+
+    ns3::CommandLine cmd;
+    cmd.AddValue("task_num", "number of tasks", task_num);
+    cmd.AddValue("admission", "reject tasks that cannot meet their deadline", admission);
+    cmd.Parse(argc, argv);
+
+    olog::set_level(olog::level::success);
+
+    okec::simulator sim;
+
+    okec::base_station_container bs(sim, 1);
+    okec::edge_device_container edge_servers(sim, 3);
+    okec::client_device_container user_devices(sim, 2);
+    bs.connect_device(edge_servers);
+
+    okec::multiple_and_single_LAN_WLAN_network_model model;
+    okec::network_initializer(model, user_devices, bs.get(0));
+
+    okec::resource_container resources(edge_servers.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", okec::rand_range(2.1, 2.2).to_string());
+    });
+    edge_servers.install_resources(resources);
+
+    // Earliest deadline first, with deadline admission control
+    auto decision_engine = std::make_shared<okec::edf_decision_engine>(&user_devices, &bs);
+    decision_engine->set_admission_control(admission);
+    decision_engine->initialize();
+
+    // Overload the edge servers: tasks arrive faster than they can be served
+    auto user = user_devices.get_device(0);
+    user->set_arrival_process(std::make_shared<okec::poisson_arrival>(20.0));
+    user->async_read([](okec::response resp) {
+        double finished = 0;
+        for (const auto& item : resp.data()) {
+            if (item["finished"] == "Y")
+                finished++;
+        }
+        olog::success("task completion rate: {:2.0f}%", finished / resp.size() * 100);
+    });
+
+    okec::task t;
+    generate_task(t, task_num, "edf");
+    user->send(t);
+
+    sim.run();
+
+    const auto& deadlines = decision_engine->deadlines();
+    okec::print("met: {}, missed: {}, rejected: {}, expired: {}, hit ratio: {:.2f}, miss ratio: {:.2f}\n",
+        deadlines.met, deadlines.missed, deadlines.rejected, deadlines.expired,
+        deadlines.hit_ratio(), deadlines.miss_ratio());
+}
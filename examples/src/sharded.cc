@@ -0,0 +1,76 @@
+#include <okec/okec.hpp>
+
+namespace olog = okec::log;
+
+
+void generate_task(okec::task& t, int number, const std::string& group) {
+    for ([[maybe_unused]] auto _ : std::views::iota(0, number)) {
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", group },
+            { "cpu", okec::rand_range(0.2, 1.2).to_string() },
+            { "deadline", okec::rand_range(10, 100).to_string() }
+        });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t shard_num = 3;
+    std::size_t task_num = 50;
+
+    ns3::CommandLine cmd;
+    cmd.AddValue("shard_num", "number of base stations", shard_num);
+    cmd.AddValue("task_num", "tasks sent to the first base station", task_num);
+    cmd.Parse(argc, argv);
+
+    olog::set_level(olog::level::success);
+
+    okec::simulator sim;
+
+    // One base station per shard, each with its own edge servers and clients
+    okec::base_station_container base_stations(sim, shard_num);
+    std::vector<okec::edge_device_container> edge_servers;
+    std::vector<okec::client_device_container> client_groups;
+    for (std::size_t i = 0; i < shard_num; ++i) {
+        edge_servers.emplace_back(sim, 3);
+        client_groups.emplace_back(sim, 2);
+    }
+    for (std::size_t i = 0; i < shard_num; ++i)
+        base_stations.get(i)->connect_device(edge_servers[i]);
+
+    okec::multiple_LAN_WLAN_network_model model;
+    okec::network_initializer(model, client_groups, base_stations);
+
+    for (auto& servers : edge_servers) {
+        okec::resource_container resources(servers.size());
+        resources.initialize([](auto res) {
+            res->attribute("cpu", okec::rand_range(2.1, 2.2).to_string());
+        });
+        servers.install_resources(resources);
+    }
+
+    // Every base station decides for its own clients and forwards what its
+    // edge servers cannot take.
+    okec::decision_shards shards(sim, client_groups, base_stations,
+        [](okec::client_device_container* clients, okec::base_station_container* bs) {
+            return std::make_shared<okec::worst_fit_decision_engine>(clients, bs);
+        });
+    shards.initialize();
+
+    // Load only the first shard, so the others receive forwarded tasks
+    auto user = client_groups[0].get_device(0);
+    user->async_read([](okec::response resp) {
+        okec::print("{:r}", resp);
+    });
+
+    okec::task t;
+    generate_task(t, task_num, "sharded");
+    user->send(t);
+
+    sim.run();
+
+    auto stats = shards.stats();
+    okec::print("dispatched: {}, forwarded: {}, conflicts: {}, retries: {}\n",
+        stats.dispatched, stats.forwarded, stats.conflicts, stats.retries);
+}
@@ -102,7 +102,7 @@ int main(int argc, char **argv)
     edge_servers.install_resources(resources);
 
     resources.trace_resource(); // 先捕捉初始值
-    resources.set_monitor([&resources](std::string_view address, std::string_view attr, std::string_view old_val, std::string_view new_val) {
+    resources.set_batch_monitor([&resources](auto) {
         resources.trace_resource();
     });
 
@@ -0,0 +1,86 @@
+#include <okec/okec.hpp>
+
+namespace olog = okec::log;
+
+
+okec::awaitable offloading(auto user, okec::task t, json& result) {
+    co_await user->async_send(std::move(t));
+    auto resp = co_await user->async_read();
+
+    double finished = 0;
+    for (const auto& item : resp.data()) {
+        if (item["finished"] == "Y") {
+            finished++;
+        }
+    }
+    result["completion_rate"] = finished / resp.size();
+}
+
+// 每个参数点在独立的进程中运行
+auto scenario(const okec::experiment_runner::run_info& info) -> json
+{
+    auto edge_num = info.params["edge_num"].get<std::size_t>();
+    auto task_num = info.params["task_num"].get<int>();
+
+    json result = info.params;
+    okec::simulator sim;
+
+    okec::base_station_container base_stations(sim, 1);
+    okec::edge_device_container edge_servers(sim, edge_num);
+    okec::client_device_container user_devices(sim, 2);
+    okec::cloud_server cloud(sim);
+    base_stations.connect_device(edge_servers);
+
+    okec::cloud_edge_end_model model;
+    okec::network_initializer(model, user_devices, base_stations.get(0), cloud);
+    base_stations.get(0)->set_position(0, 0, 0);
+    cloud.set_position(100, 0, 0);
+
+    okec::resource_container resources(edge_servers.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", okec::rand_range(2.4, 2.8).to_string());
+    });
+    edge_servers.install_resources(resources);
+
+    auto cloud_res = okec::make_resource();
+    cloud_res->attribute("cpu", "20");
+    cloud.install_resource(cloud_res);
+
+    auto decision_engine = std::make_shared<okec::cloud_edge_end_default_decision_engine>(&user_devices, &base_stations, &cloud);
+    decision_engine->initialize();
+
+    okec::task t;
+    for (auto i = task_num; i-- > 0;) {
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", "sweep" },
+            { "size",  okec::rand_range(20, 25).to_string() },
+            { "cpu", okec::rand_range(0.5, 1.5).to_string() },
+            { "deadline", okec::rand_range(2.0, 2.5).to_string() },
+        });
+    }
+
+    co_spawn(sim, offloading(user_devices.get_device(0), t, result));
+    sim.run();
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    olog::set_level(olog::level::success);
+
+    okec::parameter_grid grid;
+    grid.add("edge_num", { 3, 5, 10, 20 })
+        .add("task_num", { 10, 50, 100 });
+
+    okec::experiment_runner runner(scenario);
+    runner.seed(2024).on_result([](const auto& info, const json& result) {
+        okec::print("[{}/{}] {}\n", info.index, info.params.dump(), result.dump());
+    });
+
+    auto results = runner.run(grid);
+
+    std::ofstream file("data/sweep.json");
+    file << json(results).dump(2) << "\n";
+}
@@ -87,7 +87,7 @@ int main(int argc, char **argv)
     edge_servers.install_resources(edge_resources);
 
     edge_resources.trace_resource(); // 先捕捉初始值
-    edge_resources.set_monitor([&edge_resources](std::string_view address, std::string_view attr, std::string_view old_val, std::string_view new_val) {
+    edge_resources.set_batch_monitor([&edge_resources](auto) {
         edge_resources.trace_resource();
     });
 
@@ -0,0 +1,68 @@
+#include <okec/okec.hpp>
+
+namespace olog = okec::log;
+
+
+int main(int argc, char **argv)
+{
+    double rate = 20.0; // tasks per second
+    std::size_t task_num = 500;
+
+    ns3::CommandLine cmd;
+    cmd.AddValue("rate", "offered load in tasks per second", rate);
+    cmd.AddValue("task_num", "task number", task_num);
+    cmd.Parse(argc, argv);
+
+    olog::set_level(olog::level::success);
+
+    okec::simulator sim;
+
+    okec::base_station_container bs(sim, 1);
+    okec::edge_device_container edge_servers(sim, 5);
+    okec::client_device_container user_devices(sim, 2);
+    bs.connect_device(edge_servers);
+
+    okec::multiple_and_single_LAN_WLAN_network_model model;
+    okec::network_initializer(model, user_devices, bs.get(0));
+
+    okec::resource_container edge_resources(edge_servers.size());
+    edge_resources.initialize([](auto res) {
+        res->attribute("cpu", okec::rand_range(2.1, 2.2).to_string());
+    });
+    edge_servers.install_resources(edge_resources);
+
+    auto decision_engine = std::make_shared<okec::worst_fit_decision_engine>(&user_devices, &bs);
+    decision_engine->initialize();
+
+    // 每个任务单独成组，响应到达即可统计
+    std::size_t finished = 0;
+    double total_time = 0.0;
+    auto user = user_devices.get_device(0);
+    user->async_read([&finished, &total_time](const okec::response& resp) {
+        for (const auto& item : resp.data()) {
+            if (item["finished"] == "Y") {
+                finished++;
+                total_time += TO_DOUBLE(item["time_consuming"]);
+            }
+        }
+    });
+
+    // 泊松到达，任务在到达时刻才生成
+    okec::workload load(user, std::make_shared<okec::poisson_arrival>(rate), [](std::size_t index) {
+        okec::task t;
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", okec::format("poisson-{}", index) },
+            { "cpu", okec::rand_range(0.2, 1.2).to_string() },
+            { "deadline", okec::rand_range(10, 100).to_string() }
+        });
+        return t;
+    });
+    load.limit(task_num).start(ns3::Seconds(0.3));
+
+    sim.run();
+
+    okec::print("offered load: {} tasks/s, generated: {}, finished: {}\n", rate, load.generated(), finished);
+    okec::print("throughput: {:.3f} tasks/s, average processing time: {:.6f}s\n",
+        finished / sim.stop_time().GetSeconds(), finished ? total_time / finished : 0.0);
+}
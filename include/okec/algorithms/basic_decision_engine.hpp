@@ -0,0 +1,423 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_BASIC_DECISION_ENGINE_HPP_
+#define OKEC_BASIC_DECISION_ENGINE_HPP_
+
+#include <okec/algorithms/decision_engine.h>
+#include <okec/algorithms/placement_policies.hpp>
+#include <okec/common/arrival_process.h>
+#include <okec/common/message.h>
+#include <okec/common/simulator.h>
+#include <okec/common/task_queue.h>
+#include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
+#include <okec/devices/edge_device.h>
+#include <okec/utils/log.h>
+#include <charconv>
+#include <functional> // bind_front
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+
+namespace okec
+{
+
+// 决策所依据的资源属性，以及任务对它的需求
+//
+// key is the attribute that determines the processing time; demands() lists
+// every attribute the task consumes on a device with the given attributes.
+struct cpu_state {
+    static constexpr std::string_view key = "cpu";
+
+    static auto demand(const task_element& item) -> double {
+        return item.get_cpu();
+    }
+
+    template <class Keys>
+    static auto demands(const task_element& item, const Keys&) -> demand_vector {
+        return { { std::string(key), demand(item) } };
+    }
+};
+
+// 多维资源：任务对设备上每个数值属性的需求写在同名的 header 中（如 memory、bandwidth）
+struct vector_state {
+    static constexpr std::string_view key = "cpu";
+
+    static auto demand(const task_element& item) -> double {
+        return item.get_cpu();
+    }
+
+    template <class Keys>
+    static auto demands(const task_element& item, const Keys& keys) -> demand_vector {
+        demand_vector result;
+        for (const auto& k : keys) {
+            double amount = 0.0;
+            if (std::string_view(k) == key) {
+                amount = demand(item);
+            } else {
+                auto text = item.get_header(std::string(k));
+                std::from_chars(text.data(), text.data() + text.size(), amount);
+            }
+            if (amount > 0.0)
+                result.emplace_back(std::string(k), amount);
+        }
+        return result;
+    }
+};
+
+
+// 由放置策略、队列顺序和状态表示在编译期组合而成的决策引擎
+//
+// The skeleton owns the whole edge offloading protocol: clients send every
+// task to the decision device, which dispatches up to batch_size() of them
+// per decision point, edge servers admit by reservation version and answer
+// when the task is processed, and responses are relayed to the clients.
+// Only the choice of device varies, and it is a direct call to Placement, so
+// the scoring code inlines into handle_next(). Order is the order in which
+// the decision device's task_queue serves pending tasks.
+//
+// Placement may also be a vector_placement_policy. Combined with vector_state
+// a task then takes every resource it has a demand for, and edge servers
+// admit it only if all of them fit.
+//
+//   struct my_placement {
+//       auto operator()(double demand, const okec::placement_view& view) -> okec::device_cache::index_type;
+//   };
+//   using my_decision_engine = okec::basic_decision_engine<my_placement>;
+template <class Placement, queue_order Order = queue_order::fifo, class State = cpu_state>
+    requires placement_policy<Placement> || vector_placement_policy<Placement>
+class basic_decision_engine : public decision_engine
+{
+    using this_type = basic_decision_engine;
+
+public:
+    using placement_type = Placement;
+    using state_type     = State;
+
+    static constexpr queue_order order = Order;
+
+public:
+    basic_decision_engine() = default;
+
+    basic_decision_engine(client_device_container* clients, base_station_container* base_stations,
+        Placement placement = {})
+        : placement_{std::move(placement)}
+    {
+        this->attach(clients, base_stations);
+        this->wire(base_stations);
+    }
+
+    basic_decision_engine(std::vector<client_device_container>* clients_container, base_station_container* base_stations,
+        Placement placement = {})
+        : placement_{std::move(placement)}
+    {
+        this->attach(clients_container, base_stations);
+        this->wire(base_stations);
+        std::uint32_t zone = 0; // 第 i 组客户端连接第 i 个基站
+        for (auto& clients : *clients_container) {
+            for (const auto& client : clients)
+                zones_.emplace(client.get(), zone);
+            ++zone;
+        }
+    }
+
+    auto make_decision(const task_element& header) -> result_t override {
+        auto index = this->select(header);
+        if (index == device_cache::npos)
+            return result_t();
+
+        const auto& cache = this->cache();
+        return {
+            { "ip", okec::format("{:ip}", cache.address(index)) },
+            { "port", std::to_string(cache.port(index)) },
+            { "cpu_supply", okec::format("{}", cache.get(index, State::key)) }
+        };
+    }
+
+    auto decide(const task_element& header) -> device_cache::index_type override {
+        return this->select(header);
+    }
+
+    auto local_test(const task_element& header, client_device* client) -> bool override {
+        return false;
+    }
+
+    auto send(task_element t, std::shared_ptr<client_device> client) -> bool override {
+        // 客户端未指定到达过程时，沿用原来的发送间隔
+        if (!client->get_arrival_process())
+            client->set_arrival_process(std::make_shared<periodic_arrival>(0.01, 0.3));
+
+        client->response_cache().emplace_back({
+            { "task_id", t.get_id().to_string() },
+            { "group", t.get_group() },
+            { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
+            { "device_type", "" },
+            { "device_address", "" },
+            { "time_consuming", "" }
+        });
+
+        // 不管本地，全部往边缘服务器卸载
+        t.set_header("from_ip", okec::format("{:ip}", client->get_address()));
+        t.set_header("from_port", std::to_string(client->get_port()));
+        if (auto zone = zones_.find(client.get()); zone != zones_.end())
+            t.set_header("zone", std::to_string(zone->second));
+        message msg;
+        msg.type(message_decision);
+        msg.content(t);
+        const auto bs = this->get_decision_device();
+        auto write = [client, bs, content = msg.to_packet()]() {
+            client->write(content, bs->get_address(), bs->get_port());
+        };
+        ns3::Simulator::Schedule(ns3::Seconds(client->next_launch_delay()), write);
+
+        return true;
+    }
+
+    auto handle_next() -> void override {
+        auto& task_sequence = m_decision_device->task_sequence();
+        log::info("handle_next.... current task sequence size: {}", task_sequence.size());
+
+        // 一次最多分发 batch_size() 个任务，每次决策后在本地缓存中预留资源
+        for (std::size_t n = 0; n < this->batch_size(); ++n) {
+            auto it = task_sequence.front();
+            // 已错过截止时间的任务不再占用资源
+            while (it && this->expired(*it)) {
+                this->reject(*it, "expired");
+                it = task_sequence.front();
+            }
+            if (!it)
+                break;
+
+            auto index = this->select(*it);
+            if (index == device_cache::npos) {
+                // 分片模式下交给有空余容量的其他基站
+                if (this->forward(*it))
+                    continue;
+
+                // 等待资源释放后自动重新尝试
+                log::info("No device can handle the task({})!", it->get_id());
+                return;
+            }
+
+            auto& cache = this->cache();
+            auto id = it->get_id();
+            message msg;
+            msg.type(message_handling);
+            msg.content(*it);
+            msg.attribute("cpu_supply", okec::format("{}", cache.get(index, State::key)));
+            auto version = this->reserve(id, index, State::demands(*it, cache.keys()));
+            msg.attribute("version", std::to_string(version));
+            task_sequence.dispatch(id); // 更改任务分发状态
+
+            if (load_.size() <= index)
+                load_.resize(cache.size());
+            this->unassign(id);
+            ++load_[index];
+            assigned_.insert_or_assign(id, index);
+
+            m_decision_device->write(msg.to_packet(), cache.address(index), cache.port(index));
+        }
+    }
+
+    auto placement() -> Placement& { return placement_; }
+
+    // 每个设备在途的任务数，按 device_cache 序号
+    auto load() const -> std::span<const std::size_t> { return load_; }
+
+protected:
+    // 放置策略的直接调用，不经过 json
+    auto select(const task_element& item) -> device_cache::index_type {
+        if constexpr (vector_placement_policy<Placement>)
+            return this->select_vector(item);
+        else
+            return this->select_scalar(item);
+    }
+
+    auto select_scalar(const task_element& item) -> device_cache::index_type
+        requires placement_policy<Placement> {
+        const auto& cache = this->cache();
+        placement_view view{
+            .cache = cache,
+            .key = State::key,
+            .supply = cache.column(State::key),
+            .load = load_
+        };
+        if (auto zone = item.get_header("zone"); !zone.empty())
+            view.zone = static_cast<std::uint32_t>(std::stoul(zone));
+        if (view.supply.empty())
+            return device_cache::npos;
+        return placement_(State::demand(item), view);
+    }
+
+    // 每个维度一列，策略在所有维度上同时判断
+    auto select_vector(const task_element& item) -> device_cache::index_type
+        requires vector_placement_policy<Placement> {
+        const auto& cache = this->cache();
+        auto demand = State::demands(item, cache.keys());
+        vector_placement_view view{
+            .cache = cache,
+            .load = load_
+        };
+        if (auto zone = item.get_header("zone"); !zone.empty())
+            view.zone = static_cast<std::uint32_t>(std::stoul(zone));
+
+        // 各维度的尺度取该属性出现过的最大值
+        for (const auto& [key, amount] : demand) {
+            auto supply = cache.column(key);
+            auto& scale = scale_[key];
+            for (auto i : view.candidates()) {
+                if (i < supply.size() && supply[i] > scale)
+                    scale = supply[i];
+            }
+            view.supply.push_back(supply);
+            view.scale.push_back(scale);
+        }
+        return placement_(demand, view);
+    }
+
+    auto on_bs_decision_message(base_station* bs, message& msg, const ns3::Address& remote_address) -> void {
+        // task_element 为单位
+        auto item = msg.get_task_element();
+        item.set_status(0); // 增加处理状态信息 0: 未处理 1: 已处理
+        if (item.get_header("arrival_time").empty())
+            item.set_header("arrival_time", okec::format("{:.9f}", now::seconds()));
+
+        // 无法按时完成的任务先尝试交给其他分片，否则直接拒绝
+        if (!this->admit_deadline(item, bs->task_sequence())) {
+            if (!this->forward(item))
+                this->reject(item, "rejected");
+            return;
+        }
+
+        bs->task_sequence(std::move(item));
+        this->handle_next();
+    }
+
+    auto on_bs_response_message(base_station* bs, message& msg, const ns3::Address& remote_address) -> void {
+        auto& task_sequence = bs->task_sequence();
+
+        auto id = task_id::of(msg.get_value("task_id"));
+        if (auto it = task_sequence.find(id)) {
+            msg.attribute("group", (*it).get_group());
+            auto from_ip = (*it).get_header("from_ip");
+            auto from_port = (*it).get_header("from_port");
+            bs->write(msg.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
+            this->record_completion(*it);
+
+            // 处理过的任务从队列中清除
+            task_sequence.erase(id);
+        }
+
+        this->unassign(id);
+    }
+
+    auto unassign(const task_id& id) -> void override {
+        if (auto it = assigned_.find(id); it != assigned_.end()) {
+            --load_[it->second];
+            assigned_.erase(it);
+        }
+    }
+
+    auto on_es_handling_message(edge_device* es, message& msg, const ns3::Address& remote_address) -> void {
+        auto ipv4_remote = ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4();
+        auto task_item = msg.get_task_element();
+        auto task_id = task_item.get_id().to_string();
+
+        log::info("edge server({:ip}) has received a task({}).", es->get_address(), task_id);
+
+        auto es_resource = es->get_resource();
+        auto demand = State::demand(task_item);
+        auto demands = State::demands(task_item, es_resource->keys());
+
+        // 按预留版本校验，所有维度都满足才接受，拒绝的任务由决策设备退避后重新分配
+        if (!this->admit(es, msg, task_item, ipv4_remote, es->get_port(), demands))
+            return;
+
+        // 更改资源
+        auto supply = es_resource->get_number(State::key);
+        for (const auto& [key, amount] : demands)
+            es_resource->subtract(key, amount);
+        this->resource_changed(es, ipv4_remote, es->get_port(), task_item.get_id());
+
+        // 处理任务
+        double processing_time = demand / supply; // 任务能分发过来，supply 就不可能为0
+
+        log::info("edge server({:ip}) consumes resources: {} --> {}", es->get_address(), supply, supply - demand);
+        log::info("task(id={}) demand: {}, supply: {}, processing_time: {}", task_id, demand, supply, processing_time);
+
+        auto self = shared_from_base<this_type>();
+        ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, es, ipv4_remote, task_id, processing_time, demand, demands]() {
+            // 处理完成，释放资源
+            auto device_resource = es->get_resource();
+            auto current = device_resource->get_number(State::key);
+            for (const auto& [key, amount] : demands)
+                device_resource->add(key, amount);
+            auto device_address = okec::format("{:ip}", es->get_address());
+
+            log::info("edge server({}) restores resources: {} --> {:.2f}(demand: {})", device_address, current, current + demand, demand);
+
+            self->resource_changed(es, ipv4_remote, es->get_port());
+
+            message response {
+                { "msgtype", "response" },
+                { "task_id", task_id },
+                { "device_type", "es" },
+                { "device_address", device_address },
+                { "processing_time", okec::format("{:.9f}", processing_time) }
+            };
+            es->write(response.to_packet(), ipv4_remote, es->get_port());
+        });
+    }
+
+private:
+    auto wire(base_station_container* base_stations) -> void {
+        // 初始化资源缓存信息
+        this->initialize_device(base_stations);
+        this->cache().track(State::key, "es");
+
+        // 服务时间按当前最大的剩余资源估计
+        m_decision_device->task_sequence().set_order(Order, [this](const task_element& item) {
+            auto& cache = this->cache();
+            auto index = cache.argmax(State::key, "es");
+            auto supply = index == device_cache::npos ? 0.0 : cache.get(index, State::key);
+            return supply > 0.0 ? State::demand(item) / supply : 0.0;
+        });
+
+        // Capture decision message
+        base_stations->set_request_handler(message_decision, std::bind_front(&this_type::on_bs_decision_message, this));
+        base_stations->set_request_handler(message_response, std::bind_front(&this_type::on_bs_response_message, this));
+
+        // Capture es handling message
+        base_stations->set_es_request_handler(message_handling, std::bind_front(&this_type::on_es_handling_message, this));
+    }
+
+private:
+    Placement placement_;
+    std::vector<std::size_t> load_;                        // 每个设备在途的任务数
+    std::unordered_map<task_id, device_cache::index_type> assigned_;
+    std::unordered_map<const client_device*, std::uint32_t> zones_;
+    std::map<std::string, double, std::less<>> scale_;     // 多维放置时各属性的尺度
+};
+
+
+using best_fit_decision_engine     = basic_decision_engine<best_fit_placement>;
+using first_fit_decision_engine    = basic_decision_engine<first_fit_placement>;
+using round_robin_decision_engine  = basic_decision_engine<round_robin_placement>;
+using least_loaded_decision_engine = basic_decision_engine<least_loaded_placement>;
+using power_of_d_decision_engine   = basic_decision_engine<power_of_d_placement>;
+using edf_decision_engine          = basic_decision_engine<worst_fit_placement, queue_order::edf>;
+using dot_product_decision_engine  = basic_decision_engine<dot_product_placement, queue_order::fifo, vector_state>;
+using l2_norm_decision_engine      = basic_decision_engine<l2_norm_placement, queue_order::fifo, vector_state>;
+
+} // namespace okec
+
+#endif // OKEC_BASIC_DECISION_ENGINE_HPP_
@@ -27,27 +27,20 @@ public:
 
     auto send(task_element t, std::shared_ptr<client_device> client) -> bool override;
 
-    auto initialize() -> void override;
-
     auto train(const task& train_task, int episode = 1) -> void;
 
     auto handle_next() -> void override;
 
 private:
-    auto on_bs_decision_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_bs_decision_message(base_station* bs, message& msg, const ns3::Address& remote_address) -> void;
 
-    auto on_bs_response_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_bs_response_message(base_station* bs, message& msg, const ns3::Address& remote_address) -> void;
     
-    auto on_es_handling_message(edge_device* es, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_es_handling_message(edge_device* es, message& msg, const ns3::Address& remote_address) -> void;
     
-    auto on_cloud_handling_message(cloud_server* cs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
-
-    auto on_clients_reponse_message(client_device* client, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_cloud_handling_message(cloud_server* cs, message& msg, const ns3::Address& remote_address) -> void;
 
-private:
-    client_device_container* clients_{};
-    std::vector<client_device_container>* clients_container_{};
-    base_station_container* base_stations_{};
+    auto fill_response(json& row, message& msg) -> void override;
 };
 
 
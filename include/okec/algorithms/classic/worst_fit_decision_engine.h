@@ -11,16 +11,12 @@
 #ifndef OKEC_WORST_FIT_DECISION_ENGINE_H_
 #define OKEC_WORST_FIT_DECISION_ENGINE_H_
 
-#include <okec/algorithms/decision_engine.h>
+#include <okec/algorithms/basic_decision_engine.hpp>
 
 
 namespace okec
 {
 
-class client_device;
-class client_device_container;
-class edge_device;
-
 class DiscreteEnv : public std::enable_shared_from_this<DiscreteEnv> {
     using this_type       = DiscreteEnv;
     using done_callback_t = std::function<void(const task&, const device_cache&)>;
@@ -43,40 +39,16 @@ private:
 };
 
 
-class worst_fit_decision_engine : public decision_engine
+// Worst-fit: every task goes to the edge server with the most free CPU.
+class worst_fit_decision_engine : public basic_decision_engine<worst_fit_placement>
 {
     using this_type = worst_fit_decision_engine;
+    using base_type = basic_decision_engine<worst_fit_placement>;
 
 public:
-    worst_fit_decision_engine() = default;
-    worst_fit_decision_engine(client_device_container* clients, base_station_container* base_stations);
-    worst_fit_decision_engine(std::vector<client_device_container>* clients_container, base_station_container* base_stations);
-
-    auto make_decision(const task_element& header) -> result_t override;
-
-    auto local_test(const task_element& header, client_device* client) -> bool override;
-
-    auto send(task_element t, std::shared_ptr<client_device> client) -> bool override;
-
-    auto initialize() -> void override;
-
-    auto handle_next() -> void override;
+    using base_type::base_type;
 
     auto train(const task& t) -> void;
-
-private:
-    auto on_bs_decision_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
-
-    auto on_bs_response_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
-    
-    auto on_es_handling_message(edge_device* es, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
-    
-    auto on_clients_reponse_message(client_device* client, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
-
-private:
-    client_device_container* clients_{};
-    std::vector<client_device_container>* clients_container_{};
-    base_station_container* base_stations_{};
 };
 
 
@@ -14,6 +14,10 @@
 #include <okec/common/task.h>
 #include <okec/common/resource.h>
 #include <okec/utils/packet_helper.h>
+#include <okec/utils/indexed_heap.hpp>
+#include <map>
+#include <span>
+#include <unordered_map>
 
 
 namespace okec
@@ -22,50 +26,169 @@ namespace okec
 class base_station;
 class base_station_container;
 class client_device;
+class client_device_container;
 class edge_device;
 class cloud_server;
+class message;
+class task_queue;
 
 
+// 决策引擎使用的设备信息表
+//
+// Devices are stored column-wise: type, address, port and position are typed
+// columns, every resource attribute gets a column of doubles. Rows are never
+// removed, so a device index stays valid for the lifetime of the cache and
+// engines can hold onto it. (ip, port) lookups go through a hash index.
 class device_cache
 {
 public:
-    using attribute_type   = std::pair<std::string_view, std::string_view>;
-    using attributes_type  = std::initializer_list<attribute_type>;
-    using value_type       = json;
-    using iterator         = json::iterator;
-    using const_iterator   = json::const_iterator;
-    using unary_predicate_type  = std::function<bool(const value_type&)>;
-    using binary_predicate_type = std::function<bool(const value_type&, const value_type&)>;
+    using index_type = std::size_t;
+    using value_type = json;
+
+    static constexpr index_type npos = static_cast<index_type>(-1);
 
 public:
+    // Adds a device, or refreshes type and position if (ip, port) is known.
+    auto emplace(std::string_view device_type, ns3::Ipv4Address ip, uint16_t port,
+        const ns3::Vector& position) -> index_type;
 
-    auto begin() -> iterator;
-    auto end() -> iterator;
+    auto find(ns3::Ipv4Address ip, uint16_t port) const -> index_type;
+    auto find(std::string_view ip, std::string_view port) const -> index_type;
 
-    auto cbegin() const -> json::const_iterator;
-    auto cend() const -> json::const_iterator;
+    // first device of the given type
+    auto find_type(std::string_view device_type) const -> index_type;
 
-    auto dump(int indent = -1) const -> std::string;
+    auto size() const -> std::size_t;
 
-    auto data() const -> value_type;
+    auto empty() const -> bool;
 
-    auto view() -> value_type&;
+    auto device_type(index_type index) const -> const std::string&;
+    auto address(index_type index) const -> ns3::Ipv4Address;
+    auto port(index_type index) const -> uint16_t;
+    auto position(index_type index) const -> const ns3::Vector&;
 
-    auto size() const -> std::size_t;
+    // 所有资源属性的名称
+    auto keys() const -> std::vector<std::string_view>;
 
-    auto empty() const -> bool;
+    // 设备资源的版本，用于预留校验
+    auto version(index_type index) const -> std::uint64_t;
+    auto set_version(index_type index, std::uint64_t version) -> void;
+
+    // 设备所属区域，即其所连接基站在容器中的序号，默认为 0
+    auto zone(index_type index) const -> std::uint32_t;
+    auto set_zone(index_type index, std::uint32_t zone) -> void;
+
+    // All devices of a type, optionally only those of one zone, so policies
+    // can sample candidates without scanning the whole cache.
+    auto devices(std::string_view device_type) const -> std::span<const index_type>;
+    auto devices(std::string_view device_type, std::uint32_t zone) const -> std::span<const index_type>;
+
+    // Numeric resource attributes. get() returns NaN if the device has no
+    // numeric value for key.
+    auto get(index_type index, std::string_view key) const -> double;
+    auto set(index_type index, std::string_view key, double value) -> void;
+
+    // Text access, numbers are formatted in their shortest form.
+    auto get_value(index_type index, std::string_view key) const -> std::string;
+    auto set_value(index_type index, std::string_view key, std::string_view value) -> void;
+
+    // Overwrites every attribute the resource carries.
+    auto update(index_type index, const resource& res) -> void;
 
-    auto emplace_back(attributes_type values) -> void;
+    // All values of one attribute, indexed by device. Empty if no device has it.
+    auto column(std::string_view key) const -> std::span<const double>;
 
-    auto find_if(unary_predicate_type pred) -> iterator;
+    // Keeps a max-heap over key (restricted to one device type if given), so
+    // argmax with the same arguments becomes O(1) and set() O(log n).
+    auto track(std::string_view key, std::string_view device_type = {}) -> void;
 
-    auto sort(binary_predicate_type comp) -> void;
+    // Device with the largest value of key, optionally only of one type.
+    auto argmax(std::string_view key, std::string_view device_type = {}) const -> index_type;
+
+    auto to_json(index_type index) const -> value_type;
+
+    // Compatibility export in the former json layout.
+    auto view() const -> value_type;
+    auto data() const -> value_type;
+    auto dump(int indent = -1) const -> std::string;
 
 private:
-    auto emplace_back(value_type item) -> void;
+    struct attribute_column {
+        std::vector<double> values;
+        std::vector<std::string> text; // 非数值属性，按需分配
+    };
+
+    static auto key_of(ns3::Ipv4Address ip, uint16_t port) -> std::uint64_t {
+        return static_cast<std::uint64_t>(ip.Get()) << 16 | port;
+    }
+
+    struct tracked_index {
+        std::string key;
+        std::string device_type;
+        utils::indexed_heap<double> heap;
+    };
+
+    struct type_index {
+        std::vector<index_type> all;
+        std::unordered_map<std::uint32_t, std::vector<index_type>> zones;
+    };
+
+    auto column_for(std::string_view key) -> attribute_column&;
+
+    auto index_type_of(index_type index) -> void;
+    auto unindex_type_of(index_type index) -> void;
+
+    // 同步 index 行在各个堆中的位置
+    auto reindex(index_type index) -> void;
+    auto reindex(tracked_index& tracked, index_type index) -> void;
 
 private:
-    value_type cache;
+    std::vector<std::string> type_;
+    std::vector<ns3::Ipv4Address> ip_;
+    std::vector<uint16_t> port_;
+    std::vector<ns3::Vector> position_;
+    std::vector<std::uint64_t> version_;
+    std::vector<std::uint32_t> zone_;
+    std::map<std::string, type_index, std::less<>> by_type_;
+    std::map<std::string, attribute_column, std::less<>> attributes_;
+    std::unordered_map<std::uint64_t, index_type> index_;
+    std::vector<tracked_index> tracked_;
+};
+
+
+// 任务在各资源属性上的需求
+using demand_vector = std::vector<std::pair<std::string, double>>;
+
+
+// 分发统计
+struct dispatch_stats {
+    std::size_t dispatched = 0;     // 发出的处理请求，含重试
+    std::size_t conflicts = 0;      // 被设备拒绝的预留
+    std::size_t retries = 0;        // 退避后重新排队的任务
+    std::size_t stale_accepts = 0;  // 版本已过期但容量仍足够而被接受
+    std::uint64_t wasted_bytes = 0; // 被拒绝的请求及其冲突回复的流量
+    std::size_t forwarded = 0;      // 转发给其他分片的任务
+};
+
+// 截止时间统计，只计入带 deadline 的任务
+struct deadline_stats {
+    std::size_t admitted = 0; // 通过准入检查的任务
+    std::size_t rejected = 0; // 到达时已无法按时完成而被拒绝
+    std::size_t expired = 0;  // 排队期间超过截止时间而被丢弃
+    std::size_t met = 0;      // 按时完成
+    std::size_t missed = 0;   // 完成但超过截止时间
+
+    // Rejected and expired tasks count as misses: a task that was turned
+    // away did not meet its deadline either.
+    auto miss_ratio() const -> double {
+        auto total = met + missed + rejected + expired;
+        return total ? static_cast<double>(missed + rejected + expired) / total : 0.0;
+    }
+
+    auto hit_ratio() const -> double {
+        auto total = met + missed + rejected + expired;
+        return total ? static_cast<double>(met) / total : 0.0;
+    }
 };
 
 
@@ -82,36 +205,175 @@ protected:
         return std::static_pointer_cast<Derived>(this->shared_from_this());
     }
 
-    auto resource_changed(edge_device* es, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void;
+    // settled: the task whose handling caused the change, if any
+    auto resource_changed(edge_device* es, ns3::Ipv4Address remote_ip, uint16_t remote_port,
+        const task_id& settled = {}) -> void;
     auto conflict(edge_device* es, const task_element& item, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void;
 
+    // Debits the cache for a task that has been dispatched but not yet
+    // reported by its device. Outstanding debits are re-applied on top of
+    // every resource update, so a batch never sees the same capacity twice.
+    // Returns the device version the reservation is made against, which the
+    // handling message carries as "version".
+    auto reserve(const task_id& id, device_cache::index_type index, std::string_view key, double amount) -> std::uint64_t;
+    // all dimensions of a multi-resource task at once
+    auto reserve(const task_id& id, device_cache::index_type index, const demand_vector& demand) -> std::uint64_t;
+
+    // 释放预留；restore 时把预留量加回缓存（如任务被退回）
+    auto settle(const task_id& id, bool restore = false) -> void;
+
+    // The task no longer runs on the device it was dispatched to: it was
+    // answered, turned down by the device, forwarded, rejected or dropped
+    // as expired. Engines that keep per-device bookkeeping release it here.
+    virtual auto unassign(const task_id& id) -> void {}
+
+    // Device side check of a handling message against its reservation. A
+    // matching version means the engine decided on the current state. For
+    // a stale one the device replays the changes since that version: the
+    // task is admitted only if the capacity it was reserved against, less
+    // what other tasks took since, still covers the demand. Otherwise
+    // message_conflict is sent back and false returned.
+    auto admit(edge_device* es, message& msg, const task_element& item,
+        ns3::Ipv4Address remote_ip, uint16_t remote_port) -> bool;
+    // same for an arbitrary numeric resource attribute
+    auto admit(edge_device* es, message& msg, const task_element& item,
+        ns3::Ipv4Address remote_ip, uint16_t remote_port, std::string_view key, double demand) -> bool;
+    // all or nothing: the task is admitted only if every dimension fits
+    auto admit(edge_device* es, message& msg, const task_element& item,
+        ns3::Ipv4Address remote_ip, uint16_t remote_port, const demand_vector& demand) -> bool;
+
+    // Sharded mode: hands a task the local edge servers cannot take to the
+    // peer whose last capacity summary fits it best. The task is removed
+    // from the local queue and answered by the peer. A task is forwarded
+    // at most once.
+    auto forward(const task_element& item) -> bool;
+
+    // Earliest time item could finish if enqueued now: the CPU work served
+    // before it spread over the capacity of all edge servers, but never
+    // sooner than the task alone on the largest one. Capacity is the most
+    // free CPU a device has reported, so busy devices still count.
+    auto estimate_finish(const task_element& item, const task_queue& queue) -> double;
+
+    // 准入检查：关闭时或任务无截止时间时总是接受
+    auto admit_deadline(const task_element& item, const task_queue& queue) -> bool;
+
+    // 排队中的任务已超过截止时间
+    auto expired(const task_element& item) const -> bool;
+
+    // 任务处理完成，统计是否按时
+    auto record_completion(const task_element& item) -> void;
+
+    // Answers the client with a failure (device_type "null") and removes
+    // the task from the decision device's queue. reason is "rejected" or
+    // "expired".
+    auto reject(const task_element& item, std::string_view reason) -> void;
+
+    // Remembers the clients and base stations initialize() registers the
+    // engine with, takes the first base station as decision device and
+    // routes the responses relayed to the clients to
+    // on_clients_response_message().
+    auto attach(client_device_container* clients, base_station_container* base_stations) -> void;
+    auto attach(std::vector<client_device_container>* clients_container, base_station_container* base_stations) -> void;
+
+    // Fills the client's row of the answered task, and hands the group to
+    // the client once all of its tasks are answered.
+    auto on_clients_response_message(client_device* client, message& msg, const ns3::Address& remote_address) -> void;
+
+    // 由响应消息填写的列，默认为 device_type、device_address 和 time_consuming
+    virtual auto fill_response(json& row, message& msg) -> void;
+
 public:
     virtual ~decision_engine() {}
 
     auto calculate_distance(const ns3::Vector& pos) -> double;
     auto calculate_distance(double x, double y, double z) -> double;
 
+    // 没有决策设备时（如 analytical_simulator）用于计算距离的位置
+    auto set_decision_position(const ns3::Vector& pos) -> void;
+
     auto initialize_device(base_station_container* bs_container, cloud_server* cs) -> void;
     auto initialize_device(base_station_container* bs_container) -> void;
     
     virtual auto make_decision(const task_element& header) -> result_t = 0;
+
+    // The device make_decision() would pick, as a cache index, npos if none.
+    // The default goes through make_decision(); engines with a typed
+    // placement path override it to skip building and parsing the json.
+    virtual auto decide(const task_element& header) -> device_cache::index_type;
     
     virtual auto local_test(const task_element& header, client_device* client) -> bool = 0;
 
     virtual auto send(task_element t, std::shared_ptr<client_device> client) -> bool = 0;
 
-    virtual auto initialize() -> void = 0;
+    // 向 attach() 记录的客户端和基站注册本引擎
+    virtual auto initialize() -> void;
 
     virtual auto handle_next() -> void = 0;
 
     auto get_decision_device() const -> std::shared_ptr<base_station>;
 
+    // 每个决策点最多分发的任务数，默认为 1
+    auto set_batch_size(std::size_t k) -> void;
+    auto batch_size() const -> std::size_t;
+
+    // Rejected tasks are requeued after base * 2^(attempt - 1), capped at
+    // max, with half of the delay randomized.
+    auto set_retry_backoff(ns3::Time base, ns3::Time max) -> void;
+
+    auto stats() const -> const dispatch_stats&;
+
+    // Deadline admission control, off by default. When on, a task that
+    // cannot finish before its deadline is forwarded to a peer or rejected
+    // on arrival, and pending tasks whose deadline has passed are dropped
+    // instead of occupying the queue.
+    auto set_admission_control(bool enable) -> void;
+    auto admission_control() const -> bool;
+
+    auto deadlines() const -> const deadline_stats&;
+
+    // 分片模式下的其他基站，彼此交换边缘服务器的容量摘要
+    auto add_peer(std::shared_ptr<base_station> peer) -> void;
+
+    // 向所有 peer 发送本地边缘服务器的最大与总剩余 CPU
+    auto publish_summary() -> void;
+
     auto cache() -> device_cache&;
 
 private:
+    auto on_resource_changed(base_station* bs, message& msg) -> void;
+    auto on_conflict(base_station* bs, message& msg) -> void;
+
+private:
+    struct reservation {
+        device_cache::index_type index;
+        demand_vector amounts;
+    };
+
+    client_device_container* m_clients{};
+    std::vector<client_device_container>* m_clients_container{};
+    base_station_container* m_base_stations{};
     device_cache m_device_cache;
+    std::unordered_map<task_id, reservation> m_reservations;
+    std::unordered_map<task_id, std::size_t> m_attempts;
+
+    struct peer_state {
+        std::shared_ptr<base_station> bs;
+        double max_cpu = 0.0;
+        double total_cpu = 0.0;
+    };
+    std::vector<peer_state> m_peers;
+    std::unordered_map<std::uint64_t, std::uint32_t> m_pending_zones; // 尚未上报资源的设备所属区域
+    std::size_t m_batch_size = 1;
+    ns3::Time m_backoff_base = ns3::MilliSeconds(10);
+    ns3::Time m_backoff_max = ns3::Seconds(1);
+    ns3::Ptr<ns3::UniformRandomVariable> m_jitter;
+    dispatch_stats m_stats;
+    deadline_stats m_deadlines;
+    bool m_admission_control = false;
+    std::vector<double> m_capacity; // 每个设备上报过的最大剩余 CPU
     std::pair<ns3::Ipv4Address, uint16_t> m_cs_address;
     std::tuple<ns3::Ipv4Address, uint16_t, ns3::Vector> m_cs_info;
+    ns3::Vector m_decision_position;
 };
 
 
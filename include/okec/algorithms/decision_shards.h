@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_DECISION_SHARDS_H_
+#define OKEC_DECISION_SHARDS_H_
+
+#include <okec/algorithms/decision_engine.h>
+#include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace okec
+{
+
+class simulator;
+
+// 分片决策：每个基站运行自己的决策引擎
+//
+// Shard i consists of base_stations[i], its edge servers and clients[i], the
+// clients associated with that base station (the layout produced by
+// multiple_LAN_WLAN_network_model). Each shard decides on its own tasks, so
+// decision traffic is spread over all base stations. Shards periodically
+// exchange a summary of their free edge capacity, until the stop time of the
+// simulator, and forward a task they cannot place to the peer with the most
+// headroom.
+//
+//   okec::decision_shards shards(sim, client_groups, base_stations,
+//       [](okec::client_device_container* clients, okec::base_station_container* bs) {
+//           return std::make_shared<okec::worst_fit_decision_engine>(clients, bs);
+//       });
+//   shards.initialize();
+class decision_shards {
+public:
+    using factory_type = std::function<std::shared_ptr<decision_engine>(
+        client_device_container* clients, base_station_container* base_stations)>;
+
+public:
+    decision_shards(simulator& sim, std::vector<client_device_container>& clients,
+        base_station_container& base_stations, factory_type factory);
+    ~decision_shards();
+
+    // 初始化所有引擎，并开始交换容量摘要
+    auto initialize() -> void;
+
+    auto set_summary_interval(ns3::Time interval) -> decision_shards&;
+
+    auto size() const -> std::size_t;
+
+    auto get(std::size_t index) const -> std::shared_ptr<decision_engine>;
+
+    // 所有分片的统计之和
+    auto stats() const -> dispatch_stats;
+
+private:
+    auto publish() -> void;
+
+private:
+    simulator& sim_;
+    std::deque<base_station_container> base_stations_; // 引擎持有其指针，地址需保持不变
+    std::vector<std::shared_ptr<decision_engine>> engines_;
+    ns3::Time interval_ = ns3::Seconds(0.5);
+    ns3::EventId event_;
+};
+
+} // namespace okec
+
+#endif // OKEC_DECISION_SHARDS_H_
@@ -76,29 +76,21 @@ public:
 
     auto train(const task& train_task, int episode = 1) -> void;
 
-    auto initialize() -> void override;
-
     auto handle_next() -> void override;
 
 private:
-    auto on_bs_decision_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_bs_decision_message(base_station* bs, message& msg, const ns3::Address& remote_address) -> void;
 
-    auto on_bs_response_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
-    
-    auto on_cs_handling_message(cloud_server* cs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_bs_response_message(base_station* bs, message& msg, const ns3::Address& remote_address) -> void;
     
-    auto on_es_handling_message(edge_device* es, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_cs_handling_message(cloud_server* cs, message& msg, const ns3::Address& remote_address) -> void;
     
-    auto on_clients_reponse_message(client_device* client, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+    auto on_es_handling_message(edge_device* es, message& msg, const ns3::Address& remote_address) -> void;
 
     // episode: current episode_all: total episode
     auto train_start(const task& train_task, int episode, int episode_all) -> void;
 
 private:
-    client_device_container* clients_{};
-    std::vector<client_device_container>* clients_container_{};
-    base_station_container* base_stations_{};
-
     std::shared_ptr<DeepQNetwork> RL;
     std::vector<double> total_times_;
 };
@@ -0,0 +1,284 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_PLACEMENT_POLICIES_HPP_
+#define OKEC_PLACEMENT_POLICIES_HPP_
+
+#include <okec/algorithms/decision_engine.h>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
+
+namespace okec
+{
+
+// 放置策略看到的设备状态
+//
+// supply is the column of the state attribute (e.g. cpu) in the device
+// cache, load the number of tasks each device has been given and not yet
+// answered. Both are indexed by device_cache index.
+struct placement_view {
+    using index_type = device_cache::index_type;
+
+    const device_cache& cache;
+    std::string_view key;
+    std::span<const double> supply;
+    std::span<const std::size_t> load;
+    std::string_view device_type = "es";
+    std::optional<std::uint32_t> zone; // 任务来源客户端所属的区域（基站序号）
+
+    auto size() const noexcept -> std::size_t { return supply.size(); }
+
+    // 候选设备；local 时只包含任务所属区域内的设备
+    auto candidates(bool local = false) const -> std::span<const index_type> {
+        return local && zone ? cache.devices(device_type, *zone) : cache.devices(device_type);
+    }
+
+    auto load_of(index_type index) const noexcept -> std::size_t {
+        return index < load.size() ? load[index] : 0;
+    }
+
+    // 该设备属于候选类型且剩余资源足够
+    auto fits(index_type index, double demand) const -> bool {
+        return supply[index] >= demand && cache.device_type(index) == device_type;
+    }
+};
+
+// A placement policy picks the device for a task with the given demand, or
+// device_cache::npos if none fits. It is called for every dispatch, so keep
+// it cheap; it may keep state (see round_robin_placement).
+template <typename P>
+concept placement_policy = requires (P p, double demand, const placement_view& view) {
+    { p(demand, view) } -> std::convertible_to<device_cache::index_type>;
+};
+
+
+// 剩余资源最多的设备，借助 device_cache 的堆为 O(1)
+struct worst_fit_placement {
+    auto operator()(double demand, const placement_view& view) const -> device_cache::index_type {
+        auto index = view.cache.argmax(view.key, view.device_type);
+        return index != device_cache::npos && view.supply[index] >= demand ? index : device_cache::npos;
+    }
+};
+
+// 放得下且剩余资源最少的设备
+struct best_fit_placement {
+    auto operator()(double demand, const placement_view& view) const -> device_cache::index_type {
+        auto best = device_cache::npos;
+        for (std::size_t i = 0; i < view.size(); ++i) {
+            if (view.fits(i, demand) && (best == device_cache::npos || view.supply[i] < view.supply[best]))
+                best = i;
+        }
+        return best;
+    }
+};
+
+// 按设备顺序第一个放得下的
+struct first_fit_placement {
+    auto operator()(double demand, const placement_view& view) const -> device_cache::index_type {
+        for (std::size_t i = 0; i < view.size(); ++i) {
+            if (view.fits(i, demand))
+                return i;
+        }
+        return device_cache::npos;
+    }
+};
+
+// 从上次选中的下一个设备开始轮询
+struct round_robin_placement {
+    auto operator()(double demand, const placement_view& view) -> device_cache::index_type {
+        for (std::size_t n = 0; n < view.size(); ++n) {
+            auto i = (next_ + n) % view.size();
+            if (view.fits(i, demand)) {
+                next_ = i + 1;
+                return i;
+            }
+        }
+        return device_cache::npos;
+    }
+
+private:
+    std::size_t next_ = 0;
+};
+
+// 在途任务最少的设备，相同时取剩余资源多的
+struct least_loaded_placement {
+    auto operator()(double demand, const placement_view& view) const -> device_cache::index_type {
+        auto best = device_cache::npos;
+        for (std::size_t i = 0; i < view.size(); ++i) {
+            if (!view.fits(i, demand))
+                continue;
+            if (best == device_cache::npos || view.load_of(i) < view.load_of(best)
+                || (view.load_of(i) == view.load_of(best) && view.supply[i] > view.supply[best]))
+                best = i;
+        }
+        return best;
+    }
+};
+
+// Power of d choices: sample d candidates and take the least loaded one
+// that fits. Each decision costs O(d) whatever the fleet size, and with
+// d >= 2 the maximum load stays within O(log log n) of the average instead
+// of the O(log n / log log n) of a single random choice.
+//
+// With local set, only edge servers of the client's own base station are
+// sampled. If no sample fits after a few rounds, a non-local policy falls
+// back to the O(1) worst-fit choice so a saturated sample does not stall
+// the queue.
+struct power_of_d_placement {
+    power_of_d_placement(std::size_t d = 2, bool local = false, std::size_t rounds = 4)
+        : d{d}, local{local}, rounds{rounds} {}
+
+    std::size_t d;
+    bool local;
+    std::size_t rounds;
+
+    auto operator()(double demand, const placement_view& view) -> device_cache::index_type {
+        auto candidates = view.candidates(local);
+        if (candidates.empty())
+            return device_cache::npos;
+
+        if (!uniform_)
+            uniform_ = ns3::CreateObject<ns3::UniformRandomVariable>();
+
+        auto best = device_cache::npos;
+        auto last = static_cast<std::uint32_t>(candidates.size() - 1);
+        for (std::size_t round = 0; round < rounds && best == device_cache::npos; ++round) {
+            for (std::size_t k = 0; k < d; ++k) {
+                auto i = candidates[uniform_->GetInteger(0, last)];
+                if (!view.fits(i, demand)) // NaN 的剩余资源也不满足
+                    continue;
+                if (best == device_cache::npos || view.load_of(i) < view.load_of(best)
+                    || (view.load_of(i) == view.load_of(best) && view.supply[i] > view.supply[best]))
+                    best = i;
+            }
+        }
+
+        if (best == device_cache::npos && !local)
+            return worst_fit_placement{}(demand, view);
+        return best;
+    }
+
+private:
+    ns3::Ptr<ns3::UniformRandomVariable> uniform_;
+};
+
+
+// 多维放置策略看到的设备状态
+//
+// Dimension k is the k-th entry of the task's demand_vector: supply[k] is
+// the cache column of that attribute and scale[k] the largest value the
+// fleet has reported for it, so dimensions measured in different units
+// (cores, MB, Mbps) weigh the same.
+struct vector_placement_view {
+    using index_type = device_cache::index_type;
+
+    const device_cache& cache;
+    std::vector<std::span<const double>> supply;
+    std::vector<double> scale;
+    std::span<const std::size_t> load;
+    std::string_view device_type = "es";
+    std::optional<std::uint32_t> zone;
+
+    auto dimensions() const noexcept -> std::size_t { return supply.size(); }
+
+    auto candidates(bool local = false) const -> std::span<const index_type> {
+        return local && zone ? cache.devices(device_type, *zone) : cache.devices(device_type);
+    }
+
+    auto load_of(index_type index) const noexcept -> std::size_t {
+        return index < load.size() ? load[index] : 0;
+    }
+
+    // 归一化后的剩余资源
+    auto normalized(std::size_t k, index_type index) const -> double {
+        return scale[k] > 0.0 ? supply[k][index] / scale[k] : supply[k][index];
+    }
+
+    auto normalized(std::size_t k, const demand_vector& demand) const -> double {
+        return scale[k] > 0.0 ? demand[k].second / scale[k] : demand[k].second;
+    }
+
+    // 每个维度都放得下；设备没有上报的属性视为放不下
+    auto fits(index_type index, const demand_vector& demand) const -> bool {
+        if (cache.device_type(index) != device_type)
+            return false;
+        for (std::size_t k = 0; k < supply.size(); ++k) {
+            if (index >= supply[k].size() || !(supply[k][index] >= demand[k].second))
+                return false;
+        }
+        return true;
+    }
+};
+
+// A vector placement policy picks the device for a task that needs several
+// resources at once, or device_cache::npos if none fits in every dimension.
+template <typename P>
+concept vector_placement_policy = requires (P p, const demand_vector& demand, const vector_placement_view& view) {
+    { p(demand, view) } -> std::convertible_to<device_cache::index_type>;
+};
+
+
+// Dot product: the device whose remaining resources point the most in the
+// direction of the demand, i.e. the largest sum of normalized demand times
+// normalized supply. Tasks heavy in one dimension go where that dimension
+// is plentiful, which keeps the other dimensions usable.
+struct dot_product_placement {
+    auto operator()(const demand_vector& demand, const vector_placement_view& view) const -> device_cache::index_type {
+        auto best = device_cache::npos;
+        auto best_score = -std::numeric_limits<double>::infinity();
+        for (auto i : view.candidates()) {
+            if (!view.fits(i, demand))
+                continue;
+            double score = 0.0;
+            for (std::size_t k = 0; k < view.dimensions(); ++k)
+                score += view.normalized(k, demand) * view.normalized(k, i);
+            if (score > best_score) {
+                best = i;
+                best_score = score;
+            }
+        }
+        return best;
+    }
+};
+
+// L2 norm of the difference: the device that is left with the smallest
+// normalized remaining vector after taking the task, the multi-dimensional
+// form of best fit.
+struct l2_norm_placement {
+    auto operator()(const demand_vector& demand, const vector_placement_view& view) const -> device_cache::index_type {
+        auto best = device_cache::npos;
+        auto best_norm = std::numeric_limits<double>::infinity();
+        for (auto i : view.candidates()) {
+            if (!view.fits(i, demand))
+                continue;
+            double norm = 0.0;
+            for (std::size_t k = 0; k < view.dimensions(); ++k) {
+                auto left = view.normalized(k, i) - view.normalized(k, demand);
+                norm += left * left;
+            }
+            if (norm < best_norm) {
+                best = i;
+                best_norm = norm;
+            }
+        }
+        return best;
+    }
+};
+
+} // namespace okec
+
+#endif // OKEC_PLACEMENT_POLICIES_HPP_
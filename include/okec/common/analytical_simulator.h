@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_ANALYTICAL_SIMULATOR_H_
+#define OKEC_ANALYTICAL_SIMULATOR_H_
+
+#include <okec/algorithms/decision_engine.h>
+#include <okec/common/task.h>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+
+namespace okec
+{
+
+// 链路模型，传输时延 = size / bandwidth + propagation_delay
+struct link {
+    double bandwidth = 100.0;        // Mb/s, task size is in Mb
+    double propagation_delay = 0.0;  // s
+
+    auto delay(double size) const -> double {
+        return size / bandwidth + propagation_delay;
+    }
+};
+
+
+// 无数据包的离散事件仿真，用于在完整的 ns-3 仿真之前快速筛选决策策略
+//
+// Devices live directly in the engine's device_cache and tasks are driven
+// through decision_engine::decide(), so a policy runs exactly as it
+// does under ns-3 but without sockets: uplink (client -> base station) and
+// downlink (base station -> device) delays are computed from the configured
+// links, processing takes cpu / supply seconds, and edge servers hold the
+// task's cpu until it completes. now::seconds() follows the calendar while
+// run() is active.
+//
+//   auto engine = std::make_shared<okec::worst_fit_decision_engine>();
+//   okec::analytical_simulator sim(engine);
+//   sim.set_base_station({ 0, 0, 0 }, { .bandwidth = 50 });
+//   sim.add_edge_server(2.6, { .bandwidth = 100 });
+//   sim.submit(t);
+//   auto stats = sim.run();
+//
+// Tasks are dispatched in arrival order. When the engine returns no device,
+// or an edge server without enough cpu, the queue waits for the next
+// completion; if nothing is running the task fails instead.
+class analytical_simulator {
+public:
+    using index_type = device_cache::index_type;
+
+    enum class task_state : std::uint8_t {
+        pending,
+        running,
+        finished,
+        failed
+    };
+
+    struct task_record {
+        std::uint32_t batch;
+        std::uint32_t row;
+        double submit_time;
+        double arrival_time;     // 到达基站
+        double dispatch_time;    // 离开基站队列
+        double start_time;       // 到达设备，开始处理
+        double finish_time;
+        index_type device = device_cache::npos;
+        task_state state = task_state::pending;
+    };
+
+    struct statistics {
+        std::size_t submitted = 0;
+        std::size_t finished = 0;
+        std::size_t failed = 0;
+        std::size_t with_deadline = 0;    // 完成且有截止时间的任务
+        std::size_t deadline_met = 0;
+        std::size_t events = 0;
+        double total_response_time = 0.0; // submit -> finish
+        double total_wait_time = 0.0;     // arrival -> dispatch, queueing only
+        double makespan = 0.0;
+
+        auto mean_response_time() const -> double;
+        auto mean_wait_time() const -> double;
+        // deadline_met / with_deadline, tasks without a deadline do not count
+        auto deadline_met_ratio() const -> double;
+        auto to_json() const -> json;
+    };
+
+public:
+    explicit analytical_simulator(std::shared_ptr<decision_engine> engine);
+
+    auto set_base_station(const ns3::Vector& position, const link& uplink) -> void;
+
+    // Registers a device in the engine's cache. Addresses are made up but
+    // unique, so results can be mapped back through device_cache::find().
+    auto add_device(std::string_view device_type, double cpu, const link& downlink,
+        const ns3::Vector& position = {}) -> index_type;
+    auto add_edge_server(double cpu, const link& downlink, const ns3::Vector& position = {}) -> index_type;
+    auto add_cloud(double cpu, const link& downlink, const ns3::Vector& position = {}) -> index_type;
+
+    // Every task of t is sent at time at.
+    auto submit(task t, double at = 0.0) -> void;
+
+    // Processes events until the calendar is empty or now() passes until.
+    auto run(double until = std::numeric_limits<double>::infinity()) -> statistics;
+
+    auto now() const -> double;
+
+    auto records() const -> const std::vector<task_record>&;
+
+    auto element(std::size_t record) -> task_element;
+
+private:
+    enum class event_type : std::uint8_t {
+        arrival,
+        completion
+    };
+
+    struct event {
+        double time;
+        std::uint64_t sequence; // 同一时刻按调度顺序
+        event_type type;
+        std::uint32_t record;
+
+        auto operator>(const event& other) const -> bool {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    auto schedule(double time, event_type type, std::uint32_t record) -> void;
+
+    auto on_arrival(std::uint32_t record) -> void;
+    auto on_completion(std::uint32_t record) -> void;
+
+    // 按到达顺序分发，直到队首无法分发
+    auto dispatch() -> void;
+
+private:
+    std::shared_ptr<decision_engine> engine_;
+    std::vector<link> downlinks_; // indexed by device
+    link uplink_;
+    std::uint32_t next_address_ = 0;
+
+    std::vector<task> batches_;
+    std::vector<task_record> records_;
+    std::deque<std::uint32_t> waiting_;
+    std::size_t running_ = 0;
+
+    std::priority_queue<event, std::vector<event>, std::greater<>> calendar_;
+    std::uint64_t sequence_ = 0;
+    double now_ = 0.0;
+    statistics stats_;
+};
+
+} // namespace okec
+
+#endif // OKEC_ANALYTICAL_SIMULATOR_H_
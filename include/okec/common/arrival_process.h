@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_ARRIVAL_PROCESS_H_
+#define OKEC_ARRIVAL_PROCESS_H_
+
+#include <okec/utils/csv_reader.h>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <ns3/core-module.h>
+
+
+namespace okec
+{
+
+// 任务到达过程
+//
+// next() returns the time in seconds from the previous arrival to the next
+// one, or nullopt once the process is exhausted. Random processes draw
+// from ns-3 random variable streams, so they follow the global seed and run
+// number and every instance gets its own stream.
+class arrival_process {
+public:
+    virtual ~arrival_process() = default;
+
+    virtual auto next() -> std::optional<double> = 0;
+};
+
+
+// 泊松到达，rate 个/秒
+class poisson_arrival : public arrival_process {
+public:
+    explicit poisson_arrival(double rate);
+
+    auto next() -> std::optional<double> override;
+
+private:
+    double rate_;
+    ns3::Ptr<ns3::UniformRandomVariable> uniform_;
+};
+
+
+// 马尔可夫调制泊松过程 (MMPP)，用于突发流量
+//
+// State i emits arrivals at rates[i] and moves to state j at
+// transitions[i][j] per second. A two-state burst model:
+//
+//   mmpp_arrival({ 2.0, 50.0 }, { { 0.0, 0.1 }, { 1.0, 0.0 } });
+class mmpp_arrival : public arrival_process {
+public:
+    mmpp_arrival(std::vector<double> rates, std::vector<std::vector<double>> transitions,
+        std::size_t initial_state = 0);
+
+    auto next() -> std::optional<double> override;
+
+    auto state() const -> std::size_t;
+
+private:
+    auto exponential(double rate) -> double;
+
+    std::vector<double> rates_;
+    std::vector<std::vector<double>> transitions_;
+    std::vector<double> leave_rates_;
+    std::size_t state_;
+    ns3::Ptr<ns3::UniformRandomVariable> uniform_;
+};
+
+
+// 周期到达，第一次在 offset 之后
+class periodic_arrival : public arrival_process {
+public:
+    explicit periodic_arrival(double period, double offset = 0.0);
+
+    auto next() -> std::optional<double> override;
+
+private:
+    double period_;
+    double offset_;
+    bool started_ = false;
+};
+
+
+// 按记录的到达时刻（秒，升序）回放
+class trace_arrival : public arrival_process {
+public:
+    explicit trace_arrival(std::vector<double> timestamps);
+
+    // Streams the timestamps from one column of reader, a row per arrival,
+    // so the trace is never held in memory.
+    trace_arrival(csv_reader reader, std::size_t column);
+
+    // One timestamp per line, taken from the given comma separated column.
+    // A first line that is not a number is taken as the header; any later
+    // line whose field is not entirely a number is reported and skipped.
+    static auto load(std::string_view file, std::size_t column = 0) -> trace_arrival;
+
+    auto next() -> std::optional<double> override;
+
+    // 被跳过的无效行数
+    auto skipped() const noexcept -> std::size_t { return skipped_; }
+
+private:
+    auto next_timestamp() -> std::optional<double>;
+
+private:
+    std::vector<double> timestamps_;
+    std::size_t pos_ = 0;
+    std::unique_ptr<csv_reader> reader_; // 迭代器指向它，地址需要固定
+    csv_reader::iterator row_;
+    std::size_t column_ = 0;
+    std::size_t rows_ = 0;
+    std::size_t skipped_ = 0;
+    double last_ = 0.0;
+};
+
+} // namespace okec
+
+#endif // OKEC_ARRIVAL_PROCESS_H_
@@ -13,6 +13,10 @@
 
 #include <okec/common/response.h>
 #include <coroutine>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <ns3/core-module.h>
 
 
 namespace okec {
@@ -21,13 +25,47 @@ class client_device;
 class simulator;
 
 
+// 协程帧的内存池
+//
+// Frames up to 1 KiB come from per-thread free lists, one per 64-byte size
+// class, refilled in 64 KiB chunks; larger frames use the global allocator.
+// Chunks are kept for reuse and never returned, so spawning many short-lived
+// coroutines costs a free-list pop instead of a malloc.
+class frame_pool {
+public:
+    static auto allocate(std::size_t size) -> void*;
+    static auto deallocate(void* ptr, std::size_t size) noexcept -> void;
+};
+
+
 class awaitable_promise_base {
 public:
+    static auto operator new(std::size_t size) -> void* {
+        return frame_pool::allocate(size);
+    }
+
+    static auto operator delete(void* ptr, std::size_t size) noexcept -> void {
+        frame_pool::deallocate(ptr, size);
+    }
+
+    // 结束时转到等待者（如果有），否则挂起，由 awaitable 销毁协程帧
+    struct final_awaiter {
+        std::coroutine_handle<> continuation;
+
+        auto await_ready() const noexcept -> bool { return false; }
+        auto await_suspend(std::coroutine_handle<>) const noexcept -> std::coroutine_handle<> {
+            return continuation ? continuation : std::noop_coroutine();
+        }
+        auto await_resume() const noexcept -> void {}
+    };
+
     auto initial_suspend() noexcept -> std::suspend_never;
-    [[nodiscard]] auto final_suspend() noexcept -> std::suspend_always;
+    [[nodiscard]] auto final_suspend() noexcept -> final_awaiter;
 
     auto unhandled_exception() -> void;
     auto return_void() -> void;
+
+    std::coroutine_handle<> continuation_;
 };
 
 
@@ -46,6 +84,15 @@ public:
 
     void resume();
 
+    // true once the coroutine has finished, or if there is none
+    auto done() const noexcept -> bool;
+
+    struct awaiter;
+
+    // co_await std::move(a) resumes the caller when a finishes. The awaiter
+    // takes ownership, so a is destroyed together with the caller's frame.
+    auto operator co_await() && noexcept -> awaiter;
+
     // void start();
 
 private:
@@ -56,19 +103,155 @@ private:
     awaitable& operator=(const awaitable&) = delete;
 };
 
+struct awaitable::awaiter {
+    awaitable coro;
+
+    auto await_ready() const noexcept -> bool { return coro.done(); }
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> void {
+        coro.handle_.promise().continuation_ = handle;
+    }
+    auto await_resume() const noexcept -> void {}
+};
+
+inline auto awaitable::operator co_await() && noexcept -> awaiter {
+    return awaiter{ std::move(*this) };
+}
+
+// co_await client->async_read(token) 等待某一组的响应，token 为 0 时等待任意一组
+//
+// The waiter lives in the coroutine frame and is registered with the client
+// as a bare handle plus result slot, so a client can have any number of
+// outstanding reads without allocating a callback for each.
 class response_awaiter {
 public:
-    response_awaiter(simulator& sim, std::string client_address);
+    response_awaiter(client_device& client, completion_token token = 0);
+    response_awaiter(const response_awaiter&) = delete;
+    response_awaiter& operator=(const response_awaiter&) = delete;
+    ~response_awaiter();
+
     auto await_ready() noexcept -> bool;
     auto await_suspend(std::coroutine_handle<> handle) noexcept -> void;
     [[nodiscard]] auto await_resume() noexcept -> response;
 
 private:
-    simulator& sim;
-    std::string client_address;
+    client_device& client;
+    completion_token token;
     response r;
+    bool suspended = false; // 已向 client 注册，被放弃时需要注销
+};
+
+// co_await client->async_send(t) 立即返回任务组的完成令牌
+class send_awaiter {
+public:
+    explicit send_awaiter(completion_token token) noexcept;
+    auto await_ready() const noexcept -> bool;
+    auto await_suspend(std::coroutine_handle<>) const noexcept -> void;
+    auto await_resume() const noexcept -> completion_token;
+
+private:
+    completion_token token;
 };
 
+// 以仿真时间暂停当前协程
+//
+//   co_await okec::sleep_for(ns3::Seconds(1));
+class sleep_for {
+public:
+    explicit sleep_for(ns3::Time delay);
+    sleep_for(const sleep_for&) = delete;
+    sleep_for& operator=(const sleep_for&) = delete;
+    ~sleep_for();
+
+    auto await_ready() const noexcept -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) -> void;
+    auto await_resume() const noexcept -> void {}
+
+private:
+    ns3::Time delay_;
+    ns3::EventId event_;
+};
+
+
+// 等待全部协程结束
+auto when_all(std::vector<awaitable> coros) -> awaitable;
+
+template <class... Awaitables>
+auto when_all(awaitable first, Awaitables&&... rest) -> awaitable {
+    std::vector<awaitable> coros;
+    coros.reserve(1 + sizeof...(rest));
+    coros.push_back(std::move(first));
+    (coros.push_back(std::move(rest)), ...);
+    return when_all(std::move(coros));
+}
+
+
+// 等待任意一个协程结束，返回其下标
+//
+// The others are abandoned (their frames destroyed) once the caller moves
+// past the co_await, e.g. to stop waiting for late responses:
+//
+//   auto first = co_await okec::when_any(fetch(user, a), fetch(user, b));
+class when_any {
+public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    explicit when_any(std::vector<awaitable> coros);
+
+    template <class... Awaitables>
+    when_any(awaitable first, Awaitables&&... rest)
+        : when_any(make_vector(std::move(first), std::forward<Awaitables>(rest)...)) {}
+
+    when_any(const when_any&) = delete;
+    when_any& operator=(const when_any&) = delete;
+
+    auto await_ready() noexcept -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) -> void;
+    auto await_resume() const noexcept -> std::size_t;
+
+private:
+    template <class... Awaitables>
+    static auto make_vector(Awaitables&&... coros) -> std::vector<awaitable> {
+        std::vector<awaitable> result;
+        result.reserve(sizeof...(coros));
+        (result.push_back(std::move(coros)), ...);
+        return result;
+    }
+
+    std::vector<awaitable> coros_;
+    std::vector<awaitable> watchers_;
+    std::coroutine_handle<> waiter_;
+    std::size_t index_ = npos;
+};
+
+
+// 在 timeout 内等待协程结束，超时返回 false 并放弃该协程
+//
+//   if (!co_await okec::with_timeout(fetch(user, t), ns3::Seconds(2)))
+//       log::warning("deadline missed");
+class with_timeout {
+public:
+    with_timeout(awaitable coro, ns3::Time timeout);
+    with_timeout(const with_timeout&) = delete;
+    with_timeout& operator=(const with_timeout&) = delete;
+    ~with_timeout();
+
+    auto await_ready() noexcept -> bool;
+    auto await_suspend(std::coroutine_handle<> handle) -> void;
+    auto await_resume() const noexcept -> bool;
+
+private:
+    auto expire() -> void;
+
+    awaitable coro_;
+    awaitable watcher_;
+    ns3::Time timeout_;
+    ns3::EventId timer_;
+    std::coroutine_handle<> waiter_;
+    bool finished_ = false;
+    bool completed_ = false;
+};
+
+
 auto co_spawn(okec::simulator& ctx, okec::awaitable a) -> void;
 
 } // namespace okec
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_EXPERIMENT_RUNNER_H_
+#define OKEC_EXPERIMENT_RUNNER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+
+namespace okec
+{
+
+// 参数网格，取各参数取值的笛卡尔积
+//
+//   parameter_grid grid;
+//   grid.add("edge_num", { 3, 5, 10 })
+//       .add("task_num", { 100, 1000 });   // 6 points
+class parameter_grid {
+public:
+    auto add(std::string name, std::vector<json> values) -> parameter_grid&;
+
+    auto size() const -> std::size_t;
+
+    // Point index as an object, e.g. {"edge_num": 5, "task_num": 100}.
+    // The last parameter added varies fastest.
+    auto at(std::size_t index) const -> json;
+
+private:
+    std::vector<std::pair<std::string, std::vector<json>>> params_;
+};
+
+
+// Runs a scenario once per grid point, each in its own forked worker
+// process, so every point gets a fresh ns3::Simulator.
+//
+// Up to workers() points run at the same time. Before the scenario starts
+// the worker seeds ns-3 (RngSeedManager run number), libtorch and the
+// task_id generator with the point's seed, so a point is reproducible on
+// its own. The json the scenario returns is streamed back to the parent
+// and passed to on_result as soon as the worker finishes.
+class experiment_runner {
+public:
+    struct run_info {
+        std::size_t index;
+        json params;
+        std::uint64_t seed;
+    };
+
+    using scenario_type = std::function<json(const run_info&)>;
+    using result_callback_type = std::function<void(const run_info&, const json&)>;
+
+public:
+    explicit experiment_runner(scenario_type scenario);
+
+    // defaults to the number of hardware threads
+    auto workers(std::size_t n) -> experiment_runner&;
+
+    auto seed(std::uint64_t base) -> experiment_runner&;
+
+    auto on_result(result_callback_type fn) -> experiment_runner&;
+
+    // Blocks until every point has finished. Results are in grid order;
+    // a point whose worker failed yields {"error": "..."}.
+    auto run(const parameter_grid& grid) -> std::vector<json>;
+
+    auto seed_of(std::size_t index) const -> std::uint64_t;
+
+private:
+    scenario_type scenario_;
+    result_callback_type on_result_;
+    std::size_t workers_;
+    std::uint64_t seed_{ 1 };
+};
+
+
+} // namespace okec
+
+#endif // OKEC_EXPERIMENT_RUNNER_H_
@@ -54,6 +54,8 @@ public:
 
     auto get_task_element() -> task_element;
 
+    auto get_resource() -> resource;
+
     template <typename Type>
     auto content() -> Type {
         Type result{};
@@ -67,8 +69,12 @@ public:
 
     auto valid() -> bool;
 
+    // 接收到的数据包大小，非接收得到的消息为 0
+    auto wire_size() const noexcept -> std::uint32_t;
+
 private:
     json j_;
+    std::uint32_t wire_size_ = 0;
 };
 
 
@@ -80,6 +86,7 @@ inline constexpr std::string_view message_get_resource_information { "get_resour
 inline constexpr std::string_view message_resource_information { "resource_information" };
 inline constexpr std::string_view message_decision { "decision" };
 inline constexpr std::string_view message_conflict { "conflict" };
+inline constexpr std::string_view message_capacity_summary { "capacity_summary" };
 // inline constexpr std::string_view 
 
 } // namespace okec
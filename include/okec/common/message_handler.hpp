@@ -25,15 +25,15 @@ class message_handler {
 
 public:
 	auto add_handler(std::string_view msg_type, CallbackType callback) -> void {
-		delegate_.insert(msg_type, callback);
+		delegate_.insert(msg_type, std::move(callback));
 	}
 
 	template <typename... Args>
-	auto dispatch(const std::string& msg_type, Args... args) -> bool {
+	auto dispatch(std::string_view msg_type, Args&&... args) -> bool {
 		typename delegate_type::value_type::const_iterator iter;
 		bool ret = delegate_.find(msg_type, iter);
 		if (ret) {
-			iter->second(args...);
+			iter->second(std::forward<Args>(args)...);
 		}
 
 		return ret;
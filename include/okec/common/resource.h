@@ -14,6 +14,11 @@
 #include <okec/utils/packet_helper.h>
 #include <ns3/core-module.h>
 #include <ns3/node-container.h>
+#include <deque>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
 
 
 
@@ -27,6 +32,22 @@ public:
     // [address, key, old_value, new_value]
     using monitor_type = std::function<void(std::string_view, std::string_view, std::string_view, std::string_view)>;
 
+    struct change {
+        resource* source;
+        std::string key;
+        double old_value; // NaN if the value was not numeric
+        double new_value;
+    };
+
+    // 某个版本之后在一个属性上被占用与归还的量
+    struct drift {
+        double consumed = 0.0;
+        double released = 0.0;
+    };
+
+    // All changes made at one simulation time, delivered once that time is over.
+    using batch_monitor_type = std::function<void(std::span<const change>)>;
+
 public:
 
     static auto GetTypeId() -> ns3::TypeId;
@@ -43,18 +64,43 @@ public:
 
     auto set_monitor(monitor_type monitor) -> void;
 
+    auto set_batch_monitor(batch_monitor_type monitor) -> void;
+
     auto get_value(std::string_view key) const -> std::string;
 
+    // 数值属性，避免反复在字符串与数字之间转换
+    // get_number returns NaN if key is missing or not a number.
+    auto get_number(std::string_view key) const -> double;
+
+    // Returns the previous value.
+    auto set_number(std::string_view key, double value) -> double;
+
+    // Return the new value.
+    auto add(std::string_view key, double delta) -> double;
+    auto subtract(std::string_view key, double delta) -> double;
+
     auto get_address() -> ns3::Ipv4Address;
+
+    // 所有属性的名称
+    auto keys() const -> std::vector<std::string>;
+
+    // 每次属性变化加一，用于校验基于旧状态做出的预留
+    auto version() const -> std::uint64_t;
+
+    // Numeric changes of key made after version. nullopt once they are no
+    // longer all known: the version is older than the kept history, or the
+    // resource was replaced or set to text in between.
+    auto drift_since(std::uint64_t version, std::string_view key) const -> std::optional<drift>;
     
     auto dump(const int indent = -1) -> std::string;
 
     auto begin() const {
-        return this->empty() ? json::const_iterator() : j_["resource"].begin();
+        this->sync();
+        return this->empty() ? json::const_iterator() : j_["resource"].cbegin();
     }
 
     auto end() const {
-        return this->empty() ? json::const_iterator() : j_["resource"].end();
+        return this->empty() ? json::const_iterator() : j_["resource"].cend();
     }
 
     auto empty() const -> bool;
@@ -66,9 +112,37 @@ public:
     static auto from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> resource;
 
 private:
-    json j_;
+    friend class resource_container;
+    struct change_batch;
+
+    struct number_slot {
+        double value;
+        bool dirty; // newer than the text in j_
+    };
+
+    // writes dirty numbers back into j_
+    auto sync() const -> void;
+
+    auto notify(std::string_view key, double old_number, double new_number,
+        std::string_view old_value, std::string_view new_value) -> void;
+
+private:
+    mutable json j_;
+    mutable std::map<std::string, number_slot, std::less<>> numbers_;
     monitor_type monitor_;
+    std::shared_ptr<change_batch> batch_;
+    std::string address_;
     ns3::Ptr<ns3::Node> node_;
+    std::uint64_t version_ = 0;
+
+    struct history_entry {
+        std::uint64_t version; // 变化后的版本
+        std::string key;
+        double delta;          // 非数值变化为 NaN
+    };
+    static constexpr std::size_t history_limit = 256;
+    std::deque<history_entry> history_;
+    std::uint64_t history_floor_ = 0; // 早于它的版本无法追溯
 };
 
 
@@ -115,6 +189,10 @@ public:
 
     auto set_monitor(resource::monitor_type monitor) -> void;
 
+    // One callback per simulation time for the changes of all resources,
+    // e.g. to write a single trace row.
+    auto set_batch_monitor(resource::batch_monitor_type monitor) -> void;
+
 private:
     std::vector<ns3::Ptr<resource>> m_resources;
 };
@@ -11,14 +11,21 @@
 #ifndef OKEC_RESPONSE_H_
 #define OKEC_RESPONSE_H_
 
+#include <okec/common/task_id.h>
 #include <okec/utils/packet_helper.h>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 
 namespace okec
 {
 
+// 响应组的完成令牌，组第一次出现时分配，从 1 开始；0 表示任意组
+using completion_token = std::uint64_t;
+
 class response {
 public:
     using attribute_type         = std::pair<std::string_view, std::string_view>;
@@ -60,6 +67,7 @@ public:
     auto dump_with(attribute_type value) -> response;
 
 private:
+    friend class response_tracker;
     auto emplace_back(json item) -> void;
 
 private:
@@ -67,6 +75,69 @@ private:
 };
 
 
+// 客户端的响应缓存
+//
+// Keeps one entry per task sent, indexed by task id, and an outstanding
+// counter per group. A response is matched and a finished group detected
+// in O(1); take() hands the group's entries over without rescanning.
+class response_tracker {
+public:
+    using attributes_type = response::attributes_type;
+    using value_type      = json;
+
+public:
+    // Registers a task. values must carry "task_id" and "group"; the task
+    // counts as outstanding while "finished" is "0". Registering a task id
+    // again (e.g. the task is re-sent) replaces its entry in place; it is
+    // rejected with false if the id belongs to another group.
+    auto emplace_back(attributes_type values) -> bool;
+
+    auto find(const task_id& id) -> value_type*;
+
+    // Sets "finished" of a task, e.g. "Y" or "N". Returns false if unknown.
+    auto finish(const task_id& id, std::string_view state) -> bool;
+
+    auto contains(std::string_view group) const -> bool;
+
+    // 尚未完成的任务数
+    auto outstanding(std::string_view group) const -> std::size_t;
+
+    // Token of a group that has not been taken yet, 0 if unknown.
+    auto token(std::string_view group) const -> completion_token;
+
+    // Removes a group and returns its entries in the order they were sent.
+    auto take(std::string_view group) -> response;
+
+    auto size() const -> std::size_t;
+
+    auto empty() const -> bool;
+
+private:
+    struct group_state {
+        std::vector<value_type> items;
+        std::size_t outstanding{};
+        completion_token token{};
+    };
+
+    struct entry {
+        group_state* group;
+        std::size_t pos;
+    };
+
+    struct string_hash {
+        using is_transparent = void;
+        auto operator()(std::string_view sv) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+private:
+    std::unordered_map<std::string, group_state, string_hash, std::equal_to<>> groups_;
+    std::unordered_map<task_id, entry> index_;
+    completion_token next_token_{};
+};
+
+
 } // namespace okec
 
 #endif // OKEC_RESPONSE_H_
\ No newline at end of file
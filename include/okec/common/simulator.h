@@ -2,13 +2,12 @@
 #define OKEC_SIMULATOR_H_
 
 #include <okec/common/awaitable.h>
+#include <okec/utils/wire_format.h>
 #include <functional>
 #include <ns3/core-module.h>
 
 namespace okec {
 
-class response;
-
 class simulator {
 public:
     simulator(ns3::Time time = ns3::Seconds(300));
@@ -21,60 +20,65 @@ public:
 
     auto enable_visualizer() -> void;
 
-    auto submit(const std::string& ip, std::function<void(response&&)> fn) -> void;
-
-    auto complete(const std::string& ip, response&& r) -> void;
-
-    auto is_valid(const std::string& ip) -> bool;
+    // Encoding of control packets, binary by default. The size of the packets,
+    // and thus the simulated transmission delays, depends on this choice.
+    auto wire_format(wire::format fmt) -> void;
+    auto wire_format() const -> wire::format;
 
+    // Keeps a spawned coroutine alive until it finishes. Finished frames are
+    // released when the number of held coroutines doubles.
     auto hold_coro(awaitable a) -> void;
 
 private:
     ns3::Time stop_time_;
     std::vector<awaitable> coros_;
-    std::unordered_map<std::string, std::function<void(response&&)>> completion_;
+    std::size_t reap_threshold_ = 64;
 };
 
 namespace now {
 
+    // 非 ns-3 的时钟源（秒）。analytical_simulator 运行期间指向自己的日历时间，
+    // 其余时间为空，读取 ns-3 的 Simulator::Now()
+    inline constinit const double* clock_source = nullptr;
+
     inline auto years() -> double {
-        return ns3::Simulator::Now().GetYears();
+        return clock_source ? *clock_source / (365.0 * 24 * 3600) : ns3::Simulator::Now().GetYears();
     }
 
     inline auto days() -> double {
-        return ns3::Simulator::Now().GetDays();
+        return clock_source ? *clock_source / (24.0 * 3600) : ns3::Simulator::Now().GetDays();
     }
 
     inline auto hours() -> double {
-        return ns3::Simulator::Now().GetHours();
+        return clock_source ? *clock_source / 3600.0 : ns3::Simulator::Now().GetHours();
     }
 
     inline auto minutes() -> double {
-        return ns3::Simulator::Now().GetMinutes();
+        return clock_source ? *clock_source / 60.0 : ns3::Simulator::Now().GetMinutes();
     }
 
     inline auto seconds() -> double {
-        return ns3::Simulator::Now().GetSeconds();
+        return clock_source ? *clock_source : ns3::Simulator::Now().GetSeconds();
     }
 
     inline auto milli_seconds() -> double {
-        return ns3::Simulator::Now().GetMilliSeconds();
+        return clock_source ? *clock_source * 1e3 : ns3::Simulator::Now().GetMilliSeconds();
     }
 
     inline auto micro_seconds() -> double {
-        return ns3::Simulator::Now().GetMicroSeconds();
+        return clock_source ? *clock_source * 1e6 : ns3::Simulator::Now().GetMicroSeconds();
     }
 
     inline auto nano_seconds() -> double {
-        return ns3::Simulator::Now().GetNanoSeconds();
+        return clock_source ? *clock_source * 1e9 : ns3::Simulator::Now().GetNanoSeconds();
     }
 
     inline auto pico_seconds() -> double {
-        return ns3::Simulator::Now().GetPicoSeconds();
+        return clock_source ? *clock_source * 1e12 : ns3::Simulator::Now().GetPicoSeconds();
     }
 
     inline auto femto_seconds() -> double {
-        return ns3::Simulator::Now().GetFemtoSeconds();
+        return clock_source ? *clock_source * 1e15 : ns3::Simulator::Now().GetFemtoSeconds();
     }
 
 } // namespace now
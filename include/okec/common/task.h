@@ -11,20 +11,145 @@
 #ifndef OKEC_TASK_H_
 #define OKEC_TASK_H_
 
+#include <okec/common/task_id.h>
 #include <okec/utils/packet_helper.h>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 
 namespace okec
 {
 
+// Struct-of-arrays storage for tasks.
+//
+// The well-known header fields are kept in typed columns:
+//   task_id (128-bit), group (interned), cpu, deadline, size, status.
+// Any other header or body attribute goes to a sparse side column keyed by
+// attribute name. Numeric fields read back exactly as they were written
+// ("0.50", "100000"); the text is only kept when it differs from the
+// shortest form of the number. A value that does not parse as a number is
+// kept as-is in the side column.
+class task_table
+{
+public:
+    using size_type = std::size_t;
+    using attribute_type = std::pair<std::string, std::string>;
+
+public:
+    auto size() const noexcept -> size_type;
+    auto empty() const noexcept -> bool;
+    auto clear() -> void;
+    auto reserve(size_type n) -> void;
+
+    // append an empty row
+    auto emplace_row() -> size_type;
+
+    // append a row from { "header": {...}, "body": {...} }
+    auto append(const json& item) -> size_type;
+
+    // append a copy of other's row
+    auto append(const task_table& other, size_type row) -> size_type;
+
+    auto get_header(size_type row, std::string_view key) const -> std::string;
+    auto set_header(size_type row, std::string_view key, std::string_view value) -> void;
+    auto has_header(size_type row, std::string_view key) const -> bool;
+    auto header_equals(size_type row, std::string_view key, std::string_view value) const -> bool;
+
+    auto get_body(size_type row, std::string_view key) const -> std::string;
+    auto set_body(size_type row, std::string_view key, std::string_view value) -> void;
+
+    // attributes sorted by key, the same order as the json export
+    auto header_attributes(size_type row) const -> std::vector<attribute_type>;
+    auto body_attributes(size_type row) const -> std::vector<attribute_type>;
+
+    auto to_json(size_type row) const -> json;
+
+    // typed access, numeric fields read 0 when absent, status -1
+    auto id(size_type row) const -> task_id;
+    auto group(size_type row) const -> const std::string&;
+    auto cpu(size_type row) const -> double;
+    auto deadline(size_type row) const -> double;
+    auto data_size(size_type row) const -> double;
+    auto status(size_type row) const -> int;
+    // status is stored in one byte, values outside [0, 255] are rejected
+    auto set_status(size_type row, int value) -> bool;
+
+private:
+    enum field : std::uint8_t {
+        field_task_id  = 1 << 0,
+        field_group    = 1 << 1,
+        field_cpu      = 1 << 2,
+        field_deadline = 1 << 3,
+        field_size     = 1 << 4,
+        field_status   = 1 << 5,
+    };
+
+    struct attribute_column {
+        std::vector<std::string> values;
+        std::vector<bool> present;
+
+        auto contains(size_type row) const -> bool;
+        auto set(size_type row, std::string_view value) -> void;
+        auto erase(size_type row) -> void;
+    };
+
+    using attribute_columns = std::map<std::string, attribute_column, std::less<>>;
+
+    static auto field_of(std::string_view key) -> std::uint8_t;
+    auto intern(std::string_view name) -> std::uint32_t;
+    auto set_field(size_type row, std::uint8_t f, std::string_view value) -> bool;
+    auto get_field(size_type row, std::uint8_t f) const -> std::string;
+
+    static auto get(const attribute_columns& columns, size_type row, std::string_view key) -> std::string;
+    static auto set(attribute_columns& columns, size_type row, std::string_view key, std::string_view value) -> void;
+    static auto erase(attribute_columns& columns, size_type row, std::string_view key) -> void;
+    static auto collect(const attribute_columns& columns, size_type row, std::vector<attribute_type>& out) -> void;
+
+private:
+    std::vector<task_id>       id_;
+    std::vector<std::uint32_t> group_;
+    std::vector<double>        cpu_;
+    std::vector<double>        deadline_;
+    std::vector<double>        size_;
+    std::vector<std::uint8_t>  status_;
+    std::vector<std::uint8_t>  fields_; // bitmask of the typed fields present
+
+    std::vector<std::string> group_names_;
+    std::unordered_map<std::string, std::uint32_t> group_index_;
+
+    attribute_columns header_;
+    attribute_columns body_;
+    attribute_columns text_; // 类型化数值字段的原文，仅在与最短格式不同时保存
+};
+
+
+class task;
+
+// A row of a task_table.
+//
+// There are two kinds of elements:
+//  - views, returned by task::elements_view() / task::at(), read and write the
+//    row of the task they came from. Writes go through the task, so a copy of
+//    the task or a handle taken before the write keeps the old row. A view
+//    must not outlive its task, and is invalidated if the task is moved.
+//  - handles, everything else. A handle shares the table it was taken from, so
+//    copying one costs a reference count bump. The first write through a
+//    shared handle clones its row (copy-on-write).
+// Copying a view yields a handle holding its own copy of the row.
 class task_element
 {
 public:
-    task_element(json* item) noexcept;
-    task_element(json item) noexcept;
-    task_element(const task_element& other) noexcept;
-    task_element& operator=(const task_element& other) noexcept;
+    task_element() noexcept;
+    task_element(std::nullptr_t) noexcept;
+    task_element(json item);
+    task_element(task* owner, std::size_t row) noexcept; // view
+    task_element(std::shared_ptr<task_table> table, std::size_t row) noexcept;
+    task_element(const task_element& other);
+    task_element& operator=(const task_element& other);
     task_element(task_element&& other) noexcept;
     task_element& operator=(task_element&& other) noexcept;
     ~task_element();
@@ -35,6 +160,14 @@ public:
     auto get_body(const std::string& key) const -> std::string;
     auto set_body(std::string_view key, std::string_view value) -> bool;
 
+    auto get_id() const -> task_id;
+    auto get_group() const -> std::string;
+    auto get_cpu() const -> double;
+    auto get_deadline() const -> double;
+    auto get_size() const -> double;
+    auto get_status() const -> int; // -1 if never set
+    auto set_status(int value) -> bool; // false outside [0, 255]
+
     auto j_data() const -> json;
 
     auto empty() const -> bool;
@@ -44,8 +177,17 @@ public:
     auto dump(int indent = -1) const -> std::string;
 
 private:
-    json* elem_;
-    bool is_dynamically_allocated;
+    // 视图总是读取任务当前的表
+    auto table() const noexcept -> task_table*;
+
+    // make the row safe to modify
+    auto detach() -> void;
+
+private:
+    task* task_ = nullptr;              // 视图所属的任务
+    task_table* table_;
+    std::size_t row_;
+    std::shared_ptr<task_table> owner_; // null for views
 };
 
 class task : public ns3::SimpleRefCount<task>
@@ -58,7 +200,7 @@ public:
     using task_body = attributes_t;
 
 public:
-    task() = default;
+    task();
     task(json other);
 
     // construct task from packet
@@ -80,24 +222,35 @@ public:
 
     auto j_data() const -> json;
 
+    auto table() const noexcept -> const task_table&;
+
     auto is_null() const -> bool;
 
     auto size() const -> std::size_t;
 
-    auto empty() -> bool;
+    auto empty() const -> bool;
 
-    auto set_if(attributes_t values, auto f) -> void;
+    template <typename F>
+    auto set_if(attributes_t values, F f) -> void {
+        for (std::size_t row = 0; row < this->size(); ++row) {
+            if (match(row, values)) {
+                task_element item(this, row);
+                f(item);
+                break;
+            }
+        }
+    }
 
-    auto find_if(attributes_t values) -> task;
-    auto find_if(attribute_t value) -> task;
+    auto find_if(attributes_t values) const -> task;
+    auto find_if(attribute_t value) const -> task;
 
-    auto contains(attributes_t values) -> bool;
-    auto contains(attribute_t value) -> bool;
+    auto contains(attributes_t values) const -> bool;
+    auto contains(attribute_t value) const -> bool;
 
     static auto get_header(const json& element, const std::string& key) -> std::string;
     static auto get_body(const json& element, const std::string& key) -> std::string;
 
-    static auto unique_id() -> std::string;
+    static auto unique_id() -> task_id;
 
     auto save_to_file(const std::string& file_name) -> void;
     auto load_from_file(const std::string& file_name) -> bool;
@@ -106,13 +259,20 @@ public:
     auto operator[](std::size_t index) const noexcept -> task_element;
 
 private:
-    auto push_back(const json& sub) -> void;
+    friend class task_element;
+
+    auto match(std::size_t row, attributes_t values) const -> bool;
+
+    auto import(const json& j) -> bool;
+
+    // copy-on-write, tasks and handles share the table until one of them writes
+    auto mutable_table() -> task_table&;
 
 private:
-    json m_task;
+    std::shared_ptr<task_table> m_table;
 };
 
 
 } // namespace okec
 
-#endif // OKEC_TASK_H_
\ No newline at end of file
+#endif // OKEC_TASK_H_
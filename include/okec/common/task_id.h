@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_ID_H_
+#define OKEC_TASK_ID_H_
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace okec
+{
+
+// 128-bit task identifier.
+//
+// The text form is 32 upper-case hex digits, the same shape unique_id() used
+// to produce, so ids saved by older versions still parse.
+class task_id
+{
+public:
+    constexpr task_id() noexcept = default;
+    constexpr task_id(std::uint64_t high, std::uint64_t low) noexcept
+        : high_{ high }, low_{ low } {}
+
+    // next id from the process-wide xoshiro256** generator
+    static auto generate() noexcept -> task_id;
+
+    // reseed the generator, e.g. to make a run reproducible
+    static auto seed(std::uint64_t value) noexcept -> void;
+
+    // strict parse of the 32 hex digit form
+    static auto from_string(std::string_view sv) noexcept -> std::optional<task_id>;
+
+    // parse, or derive a stable id by hashing ids that are not in hex form
+    static auto of(std::string_view sv) noexcept -> task_id;
+
+    auto to_string() const -> std::string;
+    operator std::string() const { return to_string(); }
+
+    constexpr auto high() const noexcept -> std::uint64_t { return high_; }
+    constexpr auto low() const noexcept -> std::uint64_t { return low_; }
+
+    constexpr auto empty() const noexcept -> bool { return high_ == 0 && low_ == 0; }
+
+    friend constexpr auto operator==(const task_id&, const task_id&) noexcept -> bool = default;
+    friend constexpr auto operator<=>(const task_id&, const task_id&) noexcept = default;
+
+private:
+    std::uint64_t high_{};
+    std::uint64_t low_{};
+};
+
+
+} // namespace okec
+
+template <>
+struct std::hash<okec::task_id> {
+    auto operator()(const okec::task_id& id) const noexcept -> std::size_t {
+        // ids are random already, mixing the halves is enough
+        return static_cast<std::size_t>(id.high() ^ (id.low() * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+#endif // OKEC_TASK_ID_H_
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_QUEUE_H_
+#define OKEC_TASK_QUEUE_H_
+
+#include <okec/common/task.h>
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
+
+
+namespace okec
+{
+
+// 待分发任务的服务顺序
+enum class queue_order {
+    fifo,         // 到达顺序
+    edf,          // 绝对截止时间最早的优先
+    least_laxity, // 截止时间减去预计服务时间最小的优先
+};
+
+
+// 基站上的任务队列
+//
+// Undispatched tasks wait in the configured order (FIFO by default),
+// dispatched tasks move to the in-flight list until their response
+// arrives. Both lists are indexed by task id. FIFO is served from the
+// pending list alone, so its state transitions are O(1); the deadline
+// orders also keep a sorted index and take O(log n).
+class task_queue
+{
+public:
+    using list_type = std::list<task_element>;
+    using estimate_type = std::function<double(const task_element&)>;
+
+    // Appends to the pending list and marks the task undispatched. Tasks
+    // without an arrival_time header get the current simulation time.
+    auto push(task_element item) -> void;
+
+    // Next pending task in queue order, nullptr if nothing is waiting.
+    auto front() -> task_element*;
+
+    // Reorders the pending tasks. least_laxity needs an estimate of the
+    // service time of a task; without one it behaves like edf.
+    auto set_order(queue_order order, estimate_type service_estimate = {}) -> void;
+    auto order() const -> queue_order;
+
+    // arrival_time + deadline, infinity if the task has no deadline
+    static auto absolute_deadline(const task_element& item) -> double;
+
+    // CPU demand of the pending tasks served before item would be. O(1) for
+    // FIFO, where that is every pending task.
+    auto work_ahead(const task_element& item) const -> double;
+
+    auto find(const task_id& id) -> task_element*;
+
+    auto contains(const task_id& id) const -> bool;
+
+    auto in_flight(const task_id& id) const -> bool;
+
+    // pending -> in-flight
+    auto dispatch(const task_id& id) -> bool;
+
+    // in-flight -> front of pending, e.g. after a resource conflict
+    auto requeue(const task_id& id) -> bool;
+
+    // Removes a finished or failed task.
+    auto erase(const task_id& id) -> bool;
+
+    auto size() const -> std::size_t;
+    auto pending_size() const -> std::size_t;
+    auto in_flight_size() const -> std::size_t;
+
+    auto empty() const -> bool;
+
+    // pending() is in arrival order, whatever the queue order
+    auto pending() const -> const list_type&;
+    auto in_flight() const -> const list_type&;
+
+private:
+    using order_type = std::multimap<double, list_type::iterator>;
+
+    struct entry {
+        list_type::iterator it;
+        bool in_flight;
+        order_type::iterator rank; // 仅在截止时间顺序下 pending 时有效
+        double cpu;                // 入队时计入 pending_cpu_ 的需求
+    };
+
+    // FIFO 直接使用 pending_ 的顺序，不维护 order_
+    auto ordered() const -> bool;
+
+    // 排序键，越小越先服务
+    auto key_of(const task_element& item) -> double;
+
+private:
+    list_type pending_;
+    list_type in_flight_;
+    std::unordered_map<task_id, entry> index_;
+    order_type order_;
+    queue_order order_kind_ = queue_order::fifo;
+    estimate_type service_estimate_;
+    double pending_cpu_ = 0.0; // pending 任务的 CPU 需求之和
+};
+
+
+} // namespace okec
+
+#endif // OKEC_TASK_QUEUE_H_
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_WORKLOAD_H_
+#define OKEC_WORKLOAD_H_
+
+#include <okec/common/arrival_process.h>
+#include <okec/common/task.h>
+#include <okec/utils/csv_reader.h>
+#include <functional>
+#include <limits>
+#include <memory>
+
+
+namespace okec
+{
+
+class client_device;
+
+
+// 工作负载：按到达过程逐个生成任务并立即由客户端发出
+//
+// Tasks are created by the generator at their arrival time, not up front,
+// so long runs do not hold the whole workload in memory. The workload
+// schedules ns-3 events that refer to it and must outlive the simulation.
+//
+//   okec::workload load(user, std::make_shared<okec::poisson_arrival>(20.0),
+//       [](std::size_t index) {
+//           okec::task t;
+//           t.emplace_back({ { "task_id", okec::task::unique_id() }, { "group", "poisson" }, ... });
+//           return t;
+//       });
+//   load.limit(10000).start();
+class workload {
+public:
+    using generator_type = std::function<task(std::size_t index)>;
+
+public:
+    workload(std::shared_ptr<client_device> client, std::shared_ptr<arrival_process> arrivals,
+        generator_type generator);
+    workload(const workload&) = delete;
+    workload& operator=(const workload&) = delete;
+    ~workload();
+
+    // 最多生成的任务数
+    auto limit(std::size_t n) -> workload&;
+
+    // 不再生成晚于该时刻的任务
+    auto until(ns3::Time time) -> workload&;
+
+    // The first task arrives one inter-arrival time after offset.
+    auto start(ns3::Time offset = ns3::Seconds(0)) -> void;
+
+    auto stop() -> void;
+
+    auto generated() const -> std::size_t;
+
+private:
+    auto schedule_next(double delay) -> void;
+    auto arrive() -> void;
+
+private:
+    std::shared_ptr<client_device> client_;
+    std::shared_ptr<arrival_process> arrivals_;
+    generator_type generator_;
+    std::size_t limit_ = std::numeric_limits<std::size_t>::max();
+    double until_ = std::numeric_limits<double>::infinity();
+    std::size_t generated_ = 0;
+    ns3::EventId event_;
+};
+
+
+// 轨迹回放：按时间列逐行读取 CSV 并在对应时刻发出任务
+//
+// Rows are pulled from the reader one at a time when the previous one has
+// been launched, so only a single row is held at any moment. Timestamps are
+// relative to start() and expected to be non-decreasing; a row that lies in
+// the past is launched immediately.
+//
+//   okec::csv_reader reader("trace.csv");
+//   reader.where("type", "es");
+//   okec::trace_replay replay(user, std::move(reader), "time", [](const okec::csv_reader::row& r) {
+//       okec::task t;
+//       t.emplace_back({ { "task_id", okec::task::unique_id() }, { "cpu", std::string(r[3]) }, ... });
+//       return t;
+//   });
+//   replay.start();
+class trace_replay {
+public:
+    using builder_type = std::function<task(const csv_reader::row&)>;
+
+public:
+    trace_replay(std::shared_ptr<client_device> client, csv_reader reader,
+        std::string_view time_column, builder_type builder);
+    trace_replay(std::shared_ptr<client_device> client, csv_reader reader,
+        std::size_t time_column, builder_type builder);
+    trace_replay(const trace_replay&) = delete;
+    trace_replay& operator=(const trace_replay&) = delete;
+    ~trace_replay();
+
+    auto limit(std::size_t n) -> trace_replay&;
+
+    auto start(ns3::Time offset = ns3::Seconds(0)) -> void;
+
+    auto stop() -> void;
+
+    auto generated() const -> std::size_t;
+
+    // 时间列无法解析而被跳过的行数
+    auto skipped() const -> std::size_t;
+
+private:
+    auto schedule_next() -> void;
+    auto arrive() -> void;
+
+private:
+    std::shared_ptr<client_device> client_;
+    csv_reader reader_;
+    std::size_t time_column_;
+    builder_type builder_;
+    csv_reader::iterator it_;
+    double origin_ = 0.0;
+    std::size_t limit_ = std::numeric_limits<std::size_t>::max();
+    std::size_t generated_ = 0;
+    std::size_t skipped_ = 0;
+    ns3::EventId event_;
+};
+
+} // namespace okec
+
+#endif // OKEC_WORKLOAD_H_
@@ -13,6 +13,7 @@
 
 #include <okec/algorithms/decision_engine.h>
 #include <okec/common/message.h>
+#include <okec/common/task_queue.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/log.h>
@@ -35,6 +36,9 @@ class base_station
 public:
     using callback_type     = std::function<void(base_station*, ns3::Ptr<ns3::Packet>, const ns3::Address&)>;
     using es_callback_type  = std::function<void(edge_device*, ns3::Ptr<ns3::Packet>, const ns3::Address&)>;
+    // 使用已解码的 message，避免重复解析报文
+    using message_callback_type     = std::function<void(base_station*, message&, const ns3::Address&)>;
+    using es_message_callback_type  = std::function<void(edge_device*, message&, const ns3::Address&)>;
 
 public:
     base_station(simulator& sim);
@@ -54,8 +58,10 @@ public:
     auto push_base_stations(base_station_container* base_stations) -> void;
 
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
+    auto set_request_handler(std::string_view msg_type, message_callback_type callback) -> void;
 
     auto set_es_request_handler(std::string_view msg_type, es_callback_type callback) -> void;
+    auto set_es_request_handler(std::string_view msg_type, es_message_callback_type callback) -> void;
 
     auto set_position(double x, double y, double z) -> void;
 
@@ -69,8 +75,7 @@ public:
 
     auto task_sequence(const task_element& item) -> void;
     auto task_sequence(task_element&& item) -> void;
-    auto task_sequence() -> std::vector<task_element>&;
-    auto task_sequence_status() -> std::vector<char>&;
+    auto task_sequence() -> task_queue&;
 
     auto print_task_info() -> void;
 
@@ -81,8 +86,7 @@ public:
     edge_device_container* m_edge_devices;
     ns3::Ptr<udp_application> m_udp_application;
     ns3::Ptr<ns3::Node> m_node;
-    std::vector<task_element> m_task_sequence;
-    std::vector<char> m_task_sequence_status; // 0: 未分发；1：已分发
+    task_queue m_task_sequence;
     std::shared_ptr<decision_engine> m_decision_engine;
 };
 
@@ -93,10 +97,15 @@ public:
     using pointer_t         = std::shared_ptr<base_station>;
     using callback_type     = base_station::callback_type;
     using es_callback_type = base_station::es_callback_type;
+    using message_callback_type     = base_station::message_callback_type;
+    using es_message_callback_type  = base_station::es_message_callback_type;
 
 public:
     base_station_container(simulator& sim, std::size_t n);
 
+    // 由已有的基站组成，如分片模式下每个分片只包含一个基站
+    explicit base_station_container(std::vector<pointer_t> base_stations);
+
     template <typename... EdgeDeviceContainers>
     auto connect_device(EdgeDeviceContainers&... containers) -> bool {
         if (sizeof...(containers) != size()) {
@@ -133,8 +142,10 @@ public:
     auto size() -> std::size_t;
 
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
+    auto set_request_handler(std::string_view msg_type, message_callback_type callback) -> void;
 
     auto set_es_request_handler(std::string_view msg_type, es_callback_type callback) -> void;
+    auto set_es_request_handler(std::string_view msg_type, es_message_callback_type callback) -> void;
 
     auto set_decision_engine(std::shared_ptr<decision_engine> engine) -> void;
 
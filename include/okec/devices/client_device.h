@@ -17,8 +17,10 @@
 #include <okec/common/task.h>
 #include <okec/utils/format_helper.hpp>
 #include <coroutine>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 
@@ -27,8 +29,10 @@ namespace okec
 
 
 class udp_application;
+class arrival_process;
 class base_station;
 class response_awaiter;
+class send_awaiter;
 class simulator;
 
 
@@ -38,6 +42,7 @@ class client_device : public std::enable_shared_from_this<client_device>
     using done_callback_t = std::function<void(const response_type&)>;
 public:
     using callback_type  = std::function<void(client_device*, ns3::Ptr<ns3::Packet>, const ns3::Address&)>;
+    using message_callback_type = std::function<void(client_device*, message&, const ns3::Address&)>;
 
 public:
     client_device(simulator& sim);
@@ -59,24 +64,42 @@ public:
     // 发送时间如果是0s，因为UdpApplication的StartTime也是0s，所以m_socket可能尚未初始化，此时Write将无法发送
     auto send(task t) -> void;
 
-    auto async_send(task t) -> std::suspend_never;
+    // 返回任务所在组的完成令牌，可交给 async_read(token)
+    auto async_send(task t) -> send_awaiter;
 
+    // Sends t right away; its tasks are not spaced by the arrival process.
+    // Used by workload, which generates tasks at their arrival time.
+    auto launch(task t) -> void;
+
+    // 等待下一个完成的组
     auto async_read() -> response_awaiter;
 
+    // 等待指定的组，多个组可以同时等待
+    auto async_read(completion_token token) -> response_awaiter;
+
     auto async_read(done_callback_t fn) -> void;
 
-    auto when_done(response_type res) -> void;
+    auto when_done(completion_token token, response_type res) -> void;
 
     auto set_position(double x, double y, double z) -> void;
     auto get_position() -> ns3::Vector;
 
     auto set_decision_engine(std::shared_ptr<decision_engine> engine) -> void;
 
+    // 决策引擎按该到达过程安排 send() 中每个任务的发送时刻
+    auto set_arrival_process(std::shared_ptr<arrival_process> arrivals) -> void;
+    auto get_arrival_process() const -> std::shared_ptr<arrival_process>;
+
+    // Seconds from now until the next task goes out. Consumes one arrival;
+    // 0 without an arrival process, while launching, or once exhausted.
+    auto next_launch_delay() -> double;
+
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
+    auto set_request_handler(std::string_view msg_type, message_callback_type callback) -> void;
 
     auto dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void;
 
-    auto response_cache() -> response_type&;
+    auto response_cache() -> response_tracker&;
 
     auto has_done_callback() -> bool;
     auto done_callback(response_type res) -> void;
@@ -84,13 +107,36 @@ public:
     auto write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) const -> void;
 
 
+private:
+    friend class response_awaiter;
+
+    struct completion_waiter {
+        std::coroutine_handle<> handle;
+        response_type* result;
+    };
+
+    // 取出已完成但尚无人等待的响应，token 为 0 时取最早完成的一个
+    auto take_completed(completion_token token, response_type& out) -> bool;
+    auto await_completion(completion_token token, std::coroutine_handle<> handle, response_type* out) -> void;
+    auto cancel_completion(response_type* out) -> void;
+
 private:
     simulator& sim_;
     ns3::Ptr<ns3::Node> m_node;
     ns3::Ptr<udp_application> m_udp_application;
-    response_type m_response;
+    response_tracker m_response;
     done_callback_t m_done_fn;
     std::shared_ptr<decision_engine> m_decision_engine;
+    std::shared_ptr<arrival_process> m_arrivals;
+    double m_next_launch = 0.0; // 上一个任务的发送时刻（秒）
+    bool m_launching = false;
+
+    std::vector<std::pair<completion_token, completion_waiter>> m_waiters;
+    std::vector<completion_waiter>* m_resuming = nullptr; // when_done 正在唤醒的等待者
+    std::deque<completion_waiter> m_any_waiters;
+    std::unordered_set<completion_token> m_expected;  // async_send 发出、尚未交付的组
+    std::unordered_set<completion_token> m_abandoned; // 等待者全部放弃的组，响应到达后丢弃
+    std::deque<std::pair<completion_token, response_type>> m_completed;
 };
 
 
@@ -100,6 +146,7 @@ class client_device_container
     using value_type    = client_device;
     using pointer_type  = std::shared_ptr<value_type>;
     using callback_type = client_device::callback_type;
+    using message_callback_type = client_device::message_callback_type;
 
 public:
     // 创建含有n个ClientDevice的容器
@@ -135,6 +182,7 @@ public:
     auto set_decision_engine(std::shared_ptr<decision_engine> engine) -> void;
 
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
+    auto set_request_handler(std::string_view msg_type, message_callback_type callback) -> void;
 
 private:
     std::vector<pointer_type> m_devices;
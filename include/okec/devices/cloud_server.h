@@ -25,6 +25,7 @@ class simulator;
 
 class cloud_server {
     using callback_type  = std::function<void(cloud_server*, ns3::Ptr<ns3::Packet>, const ns3::Address&)>;
+    using message_callback_type = std::function<void(cloud_server*, message&, const ns3::Address&)>;
 
 public:
     cloud_server(simulator& sim);
@@ -49,6 +50,7 @@ public:
     auto get_position() -> ns3::Vector;
 
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
+    auto set_request_handler(std::string_view msg_type, message_callback_type callback) -> void;
 
     auto write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) const -> void;
 
@@ -27,6 +27,8 @@ class simulator;
 // 前向声明simulator类
 class task;
 // 前向声明task类
+class message;
+// 前向声明message类
 
 
 class edge_device
@@ -34,6 +36,8 @@ class edge_device
 {
     using callback_type  = std::function<void(edge_device*, ns3::Ptr<ns3::Packet>, const ns3::Address&)>;
     // 定义回调函数类型,用于处理网络消息
+    using message_callback_type = std::function<void(edge_device*, message&, const ns3::Address&)>;
+    // 定义回调函数类型,直接处理已解码的消息
 
 public:
     edge_device(simulator& sim);
@@ -65,6 +69,8 @@ public:
 
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
     // 设置请求处理器的成员函数
+    auto set_request_handler(std::string_view msg_type, message_callback_type callback) -> void;
+    // 设置请求处理器的成员函数(已解码的消息)
 
     auto write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) const -> void;
     // 发送数据包的成员函数
@@ -19,10 +19,14 @@
 namespace okec
 {
 
+class message;
+
 class udp_application : public ns3::Application
 {
 public:
     using callback_type = std::function<void(ns3::Ptr<ns3::Packet>, const ns3::Address&)>;
+    // 接收到的报文只解码一次，处理函数直接拿到解码后的 message
+    using message_callback_type = std::function<void(message&, ns3::Ptr<ns3::Packet>, const ns3::Address&)>;
 
 public:
     udp_application();
@@ -38,8 +42,11 @@ public:
     auto get_port() -> u_int16_t const;
 
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
+    auto set_request_handler(std::string_view msg_type, message_callback_type callback) -> void;
 
+    // decodes the packet, then dispatches it
     auto dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void;
+    auto dispatch(message& msg, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> bool;
 
 private:
     auto StartApplication() -> void override;
@@ -52,7 +59,7 @@ private:
     uint16_t m_port;
     ns3::Ptr<ns3::Socket> m_recv_socket;
     ns3::Ptr<ns3::Socket> m_send_socket;
-    message_handler<callback_type> m_msg_handler;
+    message_handler<message_callback_type> m_msg_handler;
 };
 
 
@@ -11,10 +11,16 @@
 #ifndef OKEC_HPP_
 #define OKEC_HPP_
 
+#include <okec/algorithms/basic_decision_engine.hpp>
 #include <okec/algorithms/classic/worst_fit_decision_engine.h>
 #include <okec/algorithms/classic/cloud_edge_end_default_decision_engine.h>
 #include <okec/algorithms/machine_learning/DQN_decision_engine.h>
+#include <okec/algorithms/decision_shards.h>
+#include <okec/common/analytical_simulator.h>
+#include <okec/common/arrival_process.h>
+#include <okec/common/experiment_runner.h>
 #include <okec/common/simulator.h>
+#include <okec/common/workload.h>
 #include <okec/mobility/ap_sta_mobility.hpp>
 #include <okec/network/multiple_and_single_LAN_WLAN_network_model.hpp>
 #include <okec/network/multiple_LAN_WLAN_network_model.hpp>
@@ -22,6 +28,7 @@
 #include <okec/utils/log.h>
 #include <okec/utils/random.hpp>
 #include <okec/utils/read_csv.h>
+#include <okec/utils/csv_reader.h>
 #include <okec/utils/visualizer.hpp>
 
 #endif // OKEC_HPP_
\ No newline at end of file
@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_CSV_READER_H_
+#define OKEC_CSV_READER_H_
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+
+namespace okec
+{
+
+// 基于 mmap 的流式 CSV 读取
+//
+// The file is mapped read-only and rows are produced one at a time as views
+// into the mapping, so a trace of any size is read in constant memory and
+// no string is allocated per cell. Fields may be quoted to contain the
+// delimiter; quoted newlines are not supported.
+//
+//   okec::csv_reader reader("trace.csv");
+//   reader.where("type", "es");
+//   for (auto [time, cpu] : reader.project<double, double>("time", "cpu"))
+//       ...
+class csv_reader {
+public:
+    class row {
+    public:
+        auto size() const noexcept -> std::size_t { return fields_.size(); }
+
+        // 字段内容，越界时为空
+        auto operator[](std::size_t index) const noexcept -> std::string_view {
+            return index < fields_.size() ? fields_[index] : std::string_view{};
+        }
+
+        // Numbers go through std::from_chars; nullopt if the field is
+        // missing or does not parse completely.
+        template <class T>
+        auto get(std::size_t index) const -> std::optional<T> {
+            auto field = (*this)[index];
+            if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>) {
+                if (index >= size())
+                    return std::nullopt;
+                return T(field);
+            } else {
+                T value{};
+                auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+                if (ec != std::errc{} || ptr != field.data() + field.size())
+                    return std::nullopt;
+                return value;
+            }
+        }
+
+        auto line() const noexcept -> std::string_view { return line_; }
+
+    private:
+        friend class csv_reader;
+
+        std::string_view line_;
+        std::vector<std::string_view> fields_; // 迭代间复用
+    };
+
+    using predicate_type = std::function<bool(const row&)>;
+
+    class iterator {
+    public:
+        using value_type        = row;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() = default;
+
+        auto operator*() const noexcept -> const row& { return row_; }
+        auto operator->() const noexcept -> const row* { return &row_; }
+        auto operator++() -> iterator&;
+        auto operator++(int) -> void { ++*this; }
+
+        friend auto operator==(const iterator& it, std::default_sentinel_t) noexcept -> bool {
+            return it.reader_ == nullptr;
+        }
+
+    private:
+        friend class csv_reader;
+        explicit iterator(const csv_reader* reader);
+
+        // 读取下一条满足条件的行，没有则变为 end
+        auto advance() -> void;
+
+        const csv_reader* reader_ = nullptr;
+        const char* pos_ = nullptr;
+        row row_;
+    };
+
+public:
+    explicit csv_reader(std::string_view file, char delimiter = ',', bool has_header = true);
+    csv_reader(csv_reader&& other) noexcept;
+    csv_reader& operator=(csv_reader&& other) noexcept;
+    ~csv_reader();
+
+    auto is_open() const noexcept -> bool;
+
+    auto header() const -> const std::vector<std::string>&;
+
+    // 列名对应的下标
+    auto column(std::string_view name) const -> std::optional<std::size_t>;
+
+    // Only rows for which every predicate holds are produced.
+    auto where(predicate_type pred) -> csv_reader&;
+    auto where(std::size_t column, std::string_view value) -> csv_reader&;
+    auto where(std::string_view column, std::string_view value) -> csv_reader&;
+
+    auto begin() const -> iterator;
+    auto end() const noexcept -> std::default_sentinel_t { return std::default_sentinel; }
+
+    // Typed column projection, by index or name. A field that is missing or
+    // does not parse yields a value-initialized T.
+    template <class... Ts, class... Columns>
+    requires (sizeof...(Ts) == sizeof...(Columns))
+    auto project(Columns... columns) const {
+        std::array<std::size_t, sizeof...(Ts)> indices{ index_of(columns)... };
+        return std::ranges::subrange(begin(), end())
+            | std::views::transform([indices](const row& r) {
+                return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return std::tuple<Ts...>{ r.get<Ts>(indices[I]).value_or(Ts{})... };
+                }(std::index_sequence_for<Ts...>{});
+            });
+    }
+
+private:
+    auto index_of(std::size_t column) const -> std::size_t { return column; }
+    auto index_of(std::string_view column) const -> std::size_t;
+    auto index_of(const char* column) const -> std::size_t { return index_of(std::string_view(column)); }
+
+    auto split(std::string_view line, std::vector<std::string_view>& fields) const -> void;
+    auto close() noexcept -> void;
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    const char* body_ = nullptr; // 表头之后的第一行
+    std::string buffer_;         // 不支持 mmap 的平台上整体读入
+    char delimiter_;
+    std::vector<std::string> header_;
+    std::vector<predicate_type> predicates_;
+};
+
+} // namespace okec
+
+#endif // OKEC_CSV_READER_H_
@@ -25,7 +25,7 @@ public:
 
 	template<typename T>
 	auto insert(T&& id, CallbackType callback) -> bool {
-		return associations_.emplace(typename value_type::value_type{ std::forward<T>(id), callback }).second;
+		return associations_.emplace(typename value_type::value_type{ std::forward<T>(id), std::move(callback) }).second;
 	}
 
 	template<typename T>
@@ -69,6 +69,21 @@ struct std::formatter<ns3::Ipv4Address> {
     }
 };
 
+// formatting okec::task_id
+template <>
+struct std::formatter<okec::task_id> {
+    constexpr auto parse(format_parse_context& ctx) {
+        auto it = ctx.begin(), end = ctx.end();
+        if (it != end && *it != '}') throw std::format_error("invalid task_id format");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const okec::task_id& id, FormatContext& ctx) const {
+        return std::vformat_to(ctx.out(), "{}", std::make_format_args(okec::unmove(id.to_string())));
+    }
+};
+
 
 // formatting okec::task
 template <>
@@ -84,27 +99,20 @@ struct std::formatter<okec::task> {
     auto format(const okec::task& t, FormatContext& ctx) const {
         int index = 1;
         std::string info;
-        for (const auto& item : t.data())
+        const auto& table = t.table();
+        for (std::size_t row = 0; row < table.size(); ++row)
         {
             info += std::vformat("[{:>{}}] ", std::make_format_args(
                 okec::unmove(index++), okec::unmove(std::to_string(t.size()).length())));
 
-            if (item.contains("/header"_json_pointer))
+            for (const auto& [key, value] : table.header_attributes(row))
             {
-                for (auto it = item["header"].begin(); it != item["header"].end(); ++it)
-                {
-                    info += std::vformat("{}: {} ", std::make_format_args(
-                        it.key(), okec::unmove(it.value().template get<std::string>())));
-                }
+                info += std::vformat("{}: {} ", std::make_format_args(key, value));
             }
 
-            if (item.contains("/body"_json_pointer))
+            for (const auto& [key, value] : table.body_attributes(row))
             {
-                for (auto it = item["body"].begin(); it != item["body"].end(); ++it)
-                {
-                    info += std::vformat("{}: {} ", std::make_format_args(
-                        it.key(), okec::unmove(it.value().template get<std::string>())));
-                }
+                info += std::vformat("{}: {} ", std::make_format_args(key, value));
             }
             info += "\n";
         }
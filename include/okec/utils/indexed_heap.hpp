@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_INDEXED_HEAP_HPP_
+#define OKEC_INDEXED_HEAP_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+namespace okec::utils
+{
+
+// Binary max-heap over the ids 0..n-1, each with a key that can be changed
+// in place. push/update/erase are O(log n), top is O(1).
+// Ties go to the smaller id, which matches std::max_element order.
+template <typename Key, typename Compare = std::less<Key>>
+class indexed_heap {
+public:
+	using id_type  = std::size_t;
+	using key_type = Key;
+
+	static constexpr id_type npos = static_cast<id_type>(-1);
+
+	indexed_heap() = default;
+	explicit indexed_heap(Compare comp) : comp_{ std::move(comp) } {}
+
+	auto size() const -> std::size_t {
+		return heap_.size();
+	}
+
+	auto empty() const -> bool {
+		return heap_.empty();
+	}
+
+	auto contains(id_type id) const -> bool {
+		return id < pos_.size() && pos_[id] != npos;
+	}
+
+	auto top() const -> id_type {
+		return heap_.empty() ? npos : heap_.front();
+	}
+
+	auto key(id_type id) const -> const key_type& {
+		return keys_[id];
+	}
+
+	// Inserts id, or changes its key if it is already in the heap.
+	auto update(id_type id, key_type key) -> void {
+		if (id >= pos_.size()) {
+			pos_.resize(id + 1, npos);
+			keys_.resize(id + 1);
+		}
+
+		keys_[id] = std::move(key);
+		if (pos_[id] == npos) {
+			pos_[id] = heap_.size();
+			heap_.push_back(id);
+			sift_up(pos_[id]);
+		} else {
+			sift_down(sift_up(pos_[id]));
+		}
+	}
+
+	auto erase(id_type id) -> void {
+		if (!contains(id))
+			return;
+
+		auto hole = pos_[id];
+		pos_[id] = npos;
+		auto last = heap_.back();
+		heap_.pop_back();
+		if (hole < heap_.size()) {
+			place(hole, last);
+			sift_down(sift_up(hole));
+		}
+	}
+
+	auto clear() -> void {
+		heap_.clear();
+		pos_.clear();
+		keys_.clear();
+	}
+
+private:
+	// a 排在 b 之前
+	auto before(id_type a, id_type b) const -> bool {
+		if (comp_(keys_[b], keys_[a]))
+			return true;
+		return !comp_(keys_[a], keys_[b]) && a < b;
+	}
+
+	auto place(std::size_t i, id_type id) -> void {
+		heap_[i] = id;
+		pos_[id] = i;
+	}
+
+	auto sift_up(std::size_t i) -> std::size_t {
+		auto id = heap_[i];
+		while (i > 0) {
+			auto parent = (i - 1) / 2;
+			if (!before(id, heap_[parent]))
+				break;
+			place(i, heap_[parent]);
+			i = parent;
+		}
+		place(i, id);
+		return i;
+	}
+
+	auto sift_down(std::size_t i) -> std::size_t {
+		auto id = heap_[i];
+		for (;;) {
+			auto child = 2 * i + 1;
+			if (child >= heap_.size())
+				break;
+			if (child + 1 < heap_.size() && before(heap_[child + 1], heap_[child]))
+				++child;
+			if (!before(heap_[child], id))
+				break;
+			place(i, heap_[child]);
+			i = child;
+		}
+		place(i, id);
+		return i;
+	}
+
+private:
+	std::vector<id_type> heap_;
+	std::vector<std::size_t> pos_;
+	std::vector<key_type> keys_;
+	Compare comp_{};
+};
+
+
+} // namespace okec::utils
+
+#endif // OKEC_INDEXED_HEAP_HPP_
@@ -11,6 +11,7 @@
 #ifndef OKEC_PACKET_HELPER_H_
 #define OKEC_PACKET_HELPER_H_
 
+#include <okec/utils/wire_format.h>
 #include <string_view>
 #include <nlohmann/json.hpp>
 #include <ns3/packet.h>
@@ -24,12 +25,22 @@ class response;
 
 namespace packet_helper {
 
+// Encoding used by to_packet, selected through okec::simulator.
+auto set_wire_format(wire::format fmt) -> void;
+auto get_wire_format() -> wire::format;
+
 auto make_packet(std::string_view sv) -> ns3::Ptr<ns3::Packet>;
 
-// convert packet to string
+// encode with the current wire format
+auto to_packet(const json& j) -> ns3::Ptr<ns3::Packet>;
+
+// payload size to_packet(j) would produce, in bytes
+auto packet_size(const json& j) -> std::size_t;
+
+// convert packet to string, binary packets are rendered as json text
 auto to_string(ns3::Ptr<ns3::Packet> packet) -> std::string;
 
-// 
+// decode a json or binary packet, returns null json on failure
 auto to_json(ns3::Ptr<ns3::Packet> packet) -> json;
 
 
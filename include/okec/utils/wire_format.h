@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_WIRE_FORMAT_H_
+#define OKEC_WIRE_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace okec {
+namespace wire {
+
+// Encoding used for control packets (message, task_element, resource).
+//
+//  json   - dump() text followed by a trailing '\0', kept for debugging.
+//  binary - versioned, tagged binary encoding described below.
+enum class format : std::uint8_t {
+    json,
+    binary
+};
+
+// Binary layout (version 1):
+//
+//   packet  := magic(0xEC) version(0x01) value
+//   value   := tag payload
+//
+//   tag   payload                                   size in bytes
+//   ----  ----------------------------------------  --------------------------
+//   0x00  null                                      1
+//   0x01  false                                     1
+//   0x02  true                                      1
+//   0x03  integer, zigzag varint                    1 + varint
+//   0x04  double, IEEE-754 little endian            1 + 8
+//   0x05  string, varint length + bytes             1 + varint(len) + len
+//   0x06  array, varint count + values              1 + varint(n) + sum(values)
+//   0x07  object, varint count + (key value) pairs  1 + varint(n) + sum(pairs)
+//   0x08  numeric string, zigzag varint             1 + varint
+//   0x09  numeric string, float32                   1 + 4
+//   0x0A  numeric string, double                    1 + 8
+//
+//   key   := id            (1 byte, one of the well-known keys)
+//          | 0xFF string   (1 + varint(len) + len)
+//
+// Attributes in okec are carried as strings ("cpu": "1.5"). A string is
+// stored as a number (0x08 - 0x0A) only when formatting the number back
+// gives the exact same text, so decode(encode(j)) == j always holds.
+//
+// varint(x) takes ceil(bits(x) / 7) bytes, 1 byte for x < 128.
+inline constexpr std::uint8_t magic   = 0xEC;
+inline constexpr std::uint8_t version = 0x01;
+
+auto encode(const json& j) -> std::vector<std::uint8_t>;
+
+// Returns a null json if the buffer is not a valid binary packet.
+auto decode(const std::uint8_t* data, std::size_t size) -> json;
+
+// Number of bytes encode(j) produces, without producing them.
+auto encoded_size(const json& j) -> std::size_t;
+
+// True if the buffer starts with the binary header.
+auto is_binary(const std::uint8_t* data, std::size_t size) -> bool;
+
+
+} // namespace wire
+} // namespace okec
+
+#endif // OKEC_WIRE_FORMAT_H_
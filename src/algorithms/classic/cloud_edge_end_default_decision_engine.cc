@@ -1,4 +1,5 @@
 #include <okec/algorithms/classic/cloud_edge_end_default_decision_engine.h>
+#include <okec/common/arrival_process.h>
 #include <okec/common/message.h>
 #include <okec/common/simulator.h>
 #include <okec/devices/base_station.h>
@@ -20,11 +21,9 @@ cloud_edge_end_default_decision_engine::cloud_edge_end_default_decision_engine(
     client_device_container* clients,
     base_station_container* base_stations,
     cloud_server* cloud)
-    : clients_{clients}
-    , base_stations_{base_stations}
 {
-    // 设置决策设备
-    m_decision_device = base_stations->get(0);
+    // 设置决策设备，捕获客户端的响应消息
+    this->attach(clients, base_stations);
 
     // 初始化资源缓存信息
     this->initialize_device(base_stations, cloud);
@@ -36,9 +35,6 @@ cloud_edge_end_default_decision_engine::cloud_edge_end_default_decision_engine(
     // Capture es handling message
     base_stations->set_es_request_handler(message_handling, std::bind_front(&this_type::on_es_handling_message, this));
 
-    // Capture clients response message
-    clients->set_request_handler(message_response, std::bind_front(&this_type::on_clients_reponse_message, this));
-
     // Capture cloud handling message
     cloud->set_request_handler(message_handling, std::bind_front(&this_type::on_cloud_handling_message, this));
 
@@ -49,27 +45,18 @@ auto cloud_edge_end_default_decision_engine::make_decision(
     const task_element &header) -> result_t
 {
     // 获取边缘设备数据
-    auto edge_cache = this->cache().data();
-    edge_cache.erase(std::remove_if(edge_cache.begin(), edge_cache.end(), [](const device_cache::value_type& item) {
-        return item["device_type"] == "cs";
-    }));
-    // okec::print("edge cache: {}\n", edge_cache.dump(2));
-
-    auto edge_max = *std::max_element(edge_cache.begin(), edge_cache.end(), 
-        [](const device_cache::value_type& lhs, const device_cache::value_type& rhs) {
-            return TO_DOUBLE(lhs["cpu"]) < TO_DOUBLE(rhs["cpu"]);
-        });
-    // okec::print("edge max: {}\n", TO_STR(edge_max["ip"]));
-
-    double cpu_demand = std::stod(header.get_header("cpu"));
-    double cpu_supply = TO_DOUBLE(edge_max["cpu"]);
-    double tolorable_time = std::stod(header.get_header("deadline"));
-    double task_size = std::stod(header.get_header("size"));
+    const auto& cache = this->cache();
+    auto edge_max = cache.argmax("cpu", "es");
+
+    double cpu_demand = header.get_cpu();
+    double cpu_supply = edge_max != device_cache::npos ? cache.get(edge_max, "cpu") : 0.0;
+    double tolorable_time = header.get_deadline();
+    double task_size = header.get_size();
     double u2b_transmission_delay = std::stod(header.get_header("transmission_delay"));
     double arrival_time = std::stod(header.get_header("arrival_time"));
     double start_time = std::stod(okec::format("{:.8f}", now::seconds())); // 保证位数一致，以防相减出现负数情况
     double wait_time = start_time - arrival_time;
-    okec::print("wait time: {}s\n", wait_time);
+    log::debug("wait time: {}s", wait_time);
 
     // okec::print("cpu_demand: {}, cpu_supply: {}, tolorable_time: {}, size: {}\n", cpu_demand, cpu_supply, tolorable_time, size);
 
@@ -81,9 +68,9 @@ auto cloud_edge_end_default_decision_engine::make_decision(
         // 能够满足时延要求
         if (total_delay < tolorable_time) {
             return {
-                { "ip", edge_max["ip"] },
-                { "port", edge_max["port"] },
-                { "cpu_supply", std::to_string(cpu_supply) },
+                { "ip", okec::format("{:ip}", cache.address(edge_max)) },
+                { "port", std::to_string(cache.port(edge_max)) },
+                { "cpu_supply", okec::format("{}", cpu_supply) },
                 { "type", "es" },
                 { "wait_time", std::to_string(wait_time) }
             };
@@ -91,19 +78,12 @@ auto cloud_edge_end_default_decision_engine::make_decision(
     }
 
     // Otherwise, dispatch the task to cloud.
-    auto it = this->cache().find_if([](const device_cache::value_type& item) {
-        return item["device_type"] == "cs";
-    });
-    if (it != this->cache().end()) {
-        const auto& device = *it;
-
-        double cs_x = TO_DOUBLE(device["pos_x"]);
-        double cs_y = TO_DOUBLE(device["pos_y"]);
-        double cs_z = TO_DOUBLE(device["pos_z"]);
-        double cloud_cpu_supply = TO_DOUBLE(device["cpu"]);
+    if (auto cs = cache.find_type("cs"); cs != device_cache::npos) {
+        const auto& cs_pos = cache.position(cs);
+        double cloud_cpu_supply = cache.get(cs, "cpu");
         double processing_time = cpu_demand / cloud_cpu_supply;
 
-        double b2c_distance = this->calculate_distance(cs_x, cs_y, cs_z);
+        double b2c_distance = this->calculate_distance(cs_pos);
         double mps_speed = 3000000.0; // 3000km/s
         double b2c_propagation_delay = b2c_distance / mps_speed;
         // 到服务器考虑往返两次的传播时延和网络时延，传输时延由于回来时响应结果非常小，可以忽略不计
@@ -117,8 +97,8 @@ auto cloud_edge_end_default_decision_engine::make_decision(
             log::warning("B2C distance is {}m. transmission delay is {}s.", b2c_distance, b2c_transmission_delay);
             
             return {
-                { "ip", device["ip"] },
-                { "port", device["port"] },
+                { "ip", okec::format("{:ip}", cache.address(cs)) },
+                { "port", std::to_string(cache.port(cs)) },
                 { "type", "cs" },
                 { "transmission_delay",  b2c_transmission_delay },
                 { "wait_time", std::to_string(wait_time) }
@@ -140,11 +120,13 @@ auto cloud_edge_end_default_decision_engine::send(
     task_element t,
     std::shared_ptr<client_device> client) -> bool
 {
-    static double launch_delay = .0; // 0.3;
+    // 客户端未指定到达过程时，沿用原来的发送间隔
+    if (!client->get_arrival_process())
+        client->set_arrival_process(std::make_shared<periodic_arrival>(1.0, 0.0));
 
     client->response_cache().emplace_back({
-        { "task_id", t.get_header("task_id") },
-        { "group", t.get_header("group") },
+        { "task_id", t.get_id().to_string() },
+        { "group", t.get_group() },
         { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
         { "device_type", "" },
         { "device_address", "" },
@@ -180,7 +162,7 @@ auto cloud_edge_end_default_decision_engine::send(
     auto write = [self, client, channelWidth, txPowerStart, t = std::move(t)]() mutable {
         auto pos = client->get_position();
         double u2b_distance = self->calculate_distance(pos.x, pos.y, pos.z);
-        double task_size = std::stod(t.get_header("size"));
+        double task_size = t.get_size();
         // double transmission_delay = /*task_size / 30 + */u2b_distance / 200000 + 0.02;
         double channel_gain = 4.11 * std::pow(3 * std::pow(10, 8) / (4 * std::numbers::pi * 915 * std::pow(10, 6) * u2b_distance), 2.8) * rand_rayleigh();
         double u2b_bandwidth = 5.0;
@@ -200,27 +182,13 @@ auto cloud_edge_end_default_decision_engine::send(
         msg.type(message_decision);
         msg.content(t);
         const auto bs = self->get_decision_device();
-        
-        // client->write(msg.to_packet(), bs->get_address(), bs->get_port());
+        client->write(msg.to_packet(), bs->get_address(), bs->get_port());
     };
-    ns3::Simulator::Schedule(ns3::Seconds(launch_delay), write);
-    // launch_delay += 0.01;
-    launch_delay += 1.0;
+    ns3::Simulator::Schedule(ns3::Seconds(client->next_launch_delay()), write);
 
     return true;
 }
 
-auto cloud_edge_end_default_decision_engine::initialize() ->void
-{
-    if (clients_) {
-        clients_->set_decision_engine(shared_from_base<this_type>());
-    }
-
-    if (base_stations_) {
-        base_stations_->set_decision_engine(shared_from_base<this_type>());
-    }
-}
-
 auto cloud_edge_end_default_decision_engine::train(const task &t, int episode) -> void
 {
 }
@@ -233,17 +201,29 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
     //     log::info("{}", element.dump());
     // }
 
-    if (auto it = std::ranges::find_if(task_sequence, [](auto const& item) {
-        return item.get_header("status") == "0";
-    }); it != std::end(task_sequence)) {
+    // 一次最多分发 batch_size() 个任务，每次决策后在本地缓存中预留资源
+    for (std::size_t n = 0; n < this->batch_size(); ++n) {
+        auto it = task_sequence.front();
+        // 已错过截止时间的任务不再占用资源
+        while (it && this->expired(*it)) {
+            this->reject(*it, "expired");
+            it = task_sequence.front();
+        }
+        if (!it)
+            break;
+
         auto target = make_decision(*it);
         // 决策失败，无法处理任务
         if (target.is_null()) {
-            log::error("No device can handle the task({})!", it->get_header("task_id"));
+            // 分片模式下交给有空余容量的其他基站
+            if (this->forward(*it))
+                continue;
+
+            log::error("No device can handle the task({})!", it->get_id());
             message response {
                 { "msgtype", "response" },
-                { "task_id", it->get_header("task_id") },
-                { "group", it->get_header("group") },
+                { "task_id", it->get_id().to_string() },
+                { "group", it->get_group() },
                 { "device_type", "null" },
                 { "device_address", "N/A" },
                 { "processing_time", "N/A" },
@@ -251,14 +231,14 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
                 { "wait_time", "N/A" }
             };
 
-            // it->set_header("status", "1"); // 更改任务分发状态
+            // it->set_status(1); // 更改任务分发状态
 
             auto from_ip = it->get_header("from_ip");
             auto from_port = it->get_header("from_port");
             m_decision_device->write(response.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
 
             // 处理过的任务从队列中清除
-            task_sequence.erase(it);
+            task_sequence.erase(it->get_id());
 
             // 如果任务列表不为空
             // if (!task_sequence.empty()) {
@@ -268,7 +248,7 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
             //         self->handle_next();
             //     });
             // }
-            return;
+            continue;
         }
 
         message msg;
@@ -279,6 +259,8 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
         if (target["type"] == "es") {
             // okec::print("target ip: {}\n", TO_STR(target["ip"]));
             msg.attribute("cpu_supply", TO_STR(target["cpu_supply"]));
+            auto version = this->reserve(it->get_id(), this->cache().find(TO_STR(target["ip"]), TO_STR(target["port"])), "cpu", it->get_cpu());
+            msg.attribute("version", std::to_string(version));
         }
 
         // 卸载到云端
@@ -292,22 +274,34 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
         }
 
         it->set_header("wait_time", TO_STR(target["wait_time"]));
-        it->set_header("status", "1"); // 更改任务分发状态
+        task_sequence.dispatch(it->get_id()); // 更改任务分发状态
         m_decision_device->write(msg.to_packet(), ns3::Ipv4Address(TO_STR(target["ip"]).c_str()), TO_INT(target["port"]));
     }
 }
 
 auto cloud_edge_end_default_decision_engine::on_bs_decision_message(
     base_station *bs,
-    ns3::Ptr<ns3::Packet> packet,
+    message& msg,
     const ns3::Address &remote_address) -> void
 {
     // okec::print("Resource cache:\n{}\n", this->cache().dump(4));
 
     // task_element 为单位
-    auto item = okec::task_element::from_msg_packet(packet);
-    item.set_header("status", "0"); // 增加处理状态信息 0: 未处理 1: 已处理
+    auto item = msg.get_task_element();
+    item.set_status(0); // 增加处理状态信息 0: 未处理 1: 已处理
     item.set_header("arrival_time", okec::format("{:.8f}", now::seconds())); // 增加任务到达时间
+
+    // 边缘服务器无法按时完成时先交给其他分片；有云服务器的话仍由 make_decision 决定是否上云
+    if (!this->admit_deadline(item, bs->task_sequence())) {
+        if (this->forward(item))
+            return;
+
+        if (this->cache().find_type("cs") == device_cache::npos) {
+            this->reject(item, "rejected");
+            return;
+        }
+    }
+
     bs->task_sequence(std::move(item));
 
     this->handle_next();
@@ -315,16 +309,14 @@ auto cloud_edge_end_default_decision_engine::on_bs_decision_message(
 
 auto cloud_edge_end_default_decision_engine::on_bs_response_message(
     base_station *bs,
-    ns3::Ptr<ns3::Packet> packet,
+    message& msg,
     const ns3::Address &remote_address) -> void
 {
-    message msg(packet);
     auto& task_sequence = bs->task_sequence();
 
-    if (auto it = std::ranges::find_if(task_sequence, [&msg](auto const& item) {
-        return item.get_header("task_id") == msg.get_value("task_id");
-    }); it != std::end(task_sequence)) {
-        msg.attribute("group", it->get_header("group"));
+    auto id = task_id::of(msg.get_value("task_id"));
+    if (auto it = task_sequence.find(id)) {
+        msg.attribute("group", it->get_group());
         msg.attribute("transmission_delay", it->get_header("transmission_delay"));
         msg.attribute("wait_time", it->get_header("wait_time"));
 
@@ -337,9 +329,10 @@ auto cloud_edge_end_default_decision_engine::on_bs_response_message(
         auto from_ip = (*it).get_header("from_ip");
         auto from_port = (*it).get_header("from_port");
         bs->write(msg.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
+        this->record_completion(*it);
 
         // 处理过的任务从队列中清除
-        task_sequence.erase(it);
+        task_sequence.erase(id);
     }
 
     this->handle_next();
@@ -347,32 +340,26 @@ auto cloud_edge_end_default_decision_engine::on_bs_response_message(
 
 auto cloud_edge_end_default_decision_engine::on_es_handling_message(
     edge_device *es,
-    ns3::Ptr<ns3::Packet> packet,
+    message& msg,
     const ns3::Address &remote_address) -> void
 {
     auto ipv4_remote = ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4();
-    message msg(packet);
-    auto task_item = msg.get_task_element(); // task_element::from_msg_packet(packet);
-    auto task_id = task_item.get_header("task_id");
+    auto task_item = msg.get_task_element();
+    auto task_id = task_item.get_id().to_string();
 
     log::info("edge server({:ip}) has received a task({}).", es->get_address(), task_id);
 
     auto es_resource = es->get_resource();
-    auto cpu_supply = std::stod(es_resource->get_value("cpu"));
-    auto cpu_demand = std::stod(task_item.get_header("cpu"));
-    auto uncertain_cpu_supply = std::stod(msg.get_value("cpu_supply"));
-
-    // 存在冲突，需要重新决策
-    if (uncertain_cpu_supply != cpu_supply || cpu_supply < cpu_demand) {
-        // 需要重新分配
-        log::error("Conflict! cpu_demand: {}, cpu_supply: {}, real_supply: {}.", cpu_demand, uncertain_cpu_supply, cpu_supply);
-        this->conflict(es, task_item, ipv4_remote, es->get_port());
+    auto cpu_supply = es_resource->get_number("cpu");
+    auto cpu_demand = task_item.get_cpu();
+
+    // 按预留版本校验，拒绝的任务由决策设备退避后重新分配
+    if (!this->admit(es, msg, task_item, ipv4_remote, es->get_port()))
         return;
-    }
 
     // 更改CPU资源
-    es_resource->reset_value("cpu", std::to_string(cpu_supply - cpu_demand));
-    this->resource_changed(es, ipv4_remote, es->get_port());
+    es_resource->subtract("cpu", cpu_demand);
+    this->resource_changed(es, ipv4_remote, es->get_port(), task_item.get_id());
 
     // 处理任务
     double processing_time = cpu_demand / cpu_supply; // 任务能分发过来，cpu_supply 就不可能为0
@@ -384,8 +371,8 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
     ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, es, ipv4_remote, task_id, processing_time, cpu_demand]() {
         // 处理完成，释放内存
         auto device_resource = es->get_resource();
-        auto cur_cpu = std::stod(device_resource->get_value("cpu"));
-        device_resource->reset_value("cpu", std::to_string(cur_cpu + cpu_demand));
+        auto cur_cpu = device_resource->get_number("cpu");
+        device_resource->add("cpu", cpu_demand);
         auto device_address = okec::format("{:ip}", es->get_address());
 
         log::info("edge server({}) restores resources: {} --> {:.2f}(demand: {})", device_address, cur_cpu, cur_cpu + cpu_demand, cpu_demand);
@@ -405,18 +392,17 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
 
 auto cloud_edge_end_default_decision_engine::on_cloud_handling_message(
     cloud_server *cs,
-    ns3::Ptr<ns3::Packet> packet,
+    message& msg,
     const ns3::Address &remote_address) -> void
 {
     log::warning("cloud handling");
     auto ipv4_remote = ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4();
-    message msg(packet);
-    auto task_item = msg.get_task_element(); // task_element::from_msg_packet(packet);
-    auto task_id = task_item.get_header("task_id");
+    auto task_item = msg.get_task_element();
+    auto task_id = task_item.get_id().to_string();
 
     auto cs_resource = cs->get_resource();
-    auto cpu_supply = std::stod(cs_resource->get_value("cpu"));
-    auto cpu_demand = std::stod(task_item.get_header("cpu"));
+    auto cpu_supply = cs_resource->get_number("cpu");
+    auto cpu_demand = task_item.get_cpu();
 
     NS_ASSERT_MSG(cpu_supply > 0, "cloud cpu cupply is not greater than 0");
 
@@ -438,44 +424,15 @@ auto cloud_edge_end_default_decision_engine::on_cloud_handling_message(
     });
 }
 
-auto cloud_edge_end_default_decision_engine::on_clients_reponse_message(
-    client_device *client,
-    ns3::Ptr<ns3::Packet> packet,
-    const ns3::Address &remote_address) -> void
+auto cloud_edge_end_default_decision_engine::fill_response(json& row, message& msg) -> void
 {
-    message msg(packet);
     log::success("{}", msg.dump());
 
-    auto it = client->response_cache().find_if([&msg](const response::value_type& item) {
-        return item["group"] == msg.get_value("group") && item["task_id"] == msg.get_value("task_id");
-    });
-    if (it != client->response_cache().end()) {
-        (*it)["device_type"] = msg.get_value("device_type");
-        (*it)["device_address"] = msg.get_value("device_address");
-        (*it)["processing_delay"] = msg.get_value("processing_time");
-        (*it)["transmission_delay"] = msg.get_value("transmission_delay");
-        (*it)["wait_time"] = msg.get_value("wait_time");
-        (*it)["finished"] = msg.get_value("device_type") != "null" ? "Y" : "N";
-
-        log::success("client({:ip}) has received a response for task(id={}).", client->get_address(), msg.get_value("task_id"));
-    }
-
-    // 检查是否存在当前任务的信息
-    auto exist = client->response_cache().find_if([&msg](const auto& item) {
-        return item["group"] == msg.get_value("group");
-    });
-    if (exist == client->response_cache().end()) {
-        log::error("Fatal error! Invalid response."); // 说明发出去的数据被修改，或是 m_response 被无意间删除了信息
-        return;
-    }
-
-    // 全部完成
-    auto unfinished = client->response_cache().find_if([&msg](const auto& item) {
-        return item["group"] == msg.get_value("group") && item["finished"] == "0";
-    });
-    if (unfinished == client->response_cache().end()) {
-        client->when_done(client->response_cache().dump_with({ "group", msg.get_value("group") }));
-    }
+    row["device_type"] = msg.get_value("device_type");
+    row["device_address"] = msg.get_value("device_address");
+    row["processing_delay"] = msg.get_value("processing_time");
+    row["transmission_delay"] = msg.get_value("transmission_delay");
+    row["wait_time"] = msg.get_value("wait_time");
 }
 
 } // namespace okec
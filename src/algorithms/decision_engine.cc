@@ -10,97 +10,366 @@
 
 #include <okec/algorithms/decision_engine.h>
 #include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/format_helper.hpp>
 #include <okec/utils/log.h>
 #include <algorithm>
 #include <charconv>
+#include <cmath>
+#include <functional> // bind_front
+#include <limits>
+#include <optional>
 #include <ranges>
 
 
 namespace okec
 {
 
-auto device_cache::begin() -> iterator
-{
-    return this->view().begin();
-}
+namespace {
 
-auto device_cache::end() -> iterator
+auto format_number(double value) -> std::string
 {
-    return this->view().end();
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    return std::string(buf, end);
 }
 
-auto device_cache::cbegin() const -> json::const_iterator
+// 完整解析为数字才算数值属性
+auto parse_number(std::string_view sv, double& value) -> bool
 {
-    return this->cache["device_cache"]["items"].cbegin();
+    if (sv.empty())
+        return false;
+    auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), value);
+    return ec == std::errc{} && ptr == sv.data() + sv.size();
 }
 
-auto device_cache::cend() const -> json::const_iterator
+} // namespace
+
+auto device_cache::emplace(std::string_view device_type, ns3::Ipv4Address ip, uint16_t port,
+    const ns3::Vector& position) -> index_type
 {
-    return this->cache["device_cache"]["items"].cend();
+    auto [it, inserted] = index_.try_emplace(key_of(ip, port), type_.size());
+    auto index = it->second;
+    if (!inserted) {
+        position_[index] = position;
+        if (type_[index] != device_type) {
+            this->unindex_type_of(index);
+            type_[index] = device_type;
+            this->index_type_of(index);
+            this->reindex(index);
+        }
+        return index;
+    }
+
+    type_.emplace_back(device_type);
+    ip_.push_back(ip);
+    port_.push_back(port);
+    position_.push_back(position);
+    version_.push_back(0);
+    zone_.push_back(0);
+    for (auto& [_, column] : attributes_) {
+        column.values.push_back(std::numeric_limits<double>::quiet_NaN());
+        if (!column.text.empty())
+            column.text.emplace_back();
+    }
+
+    this->index_type_of(index);
+    return index;
 }
 
-auto device_cache::dump(int indent) const -> std::string
+auto device_cache::find(ns3::Ipv4Address ip, uint16_t port) const -> index_type
 {
-    return this->cache.dump(indent);
+    auto it = index_.find(key_of(ip, port));
+    return it == index_.end() ? npos : it->second;
 }
 
-auto device_cache::data() const -> value_type
+auto device_cache::find(std::string_view ip, std::string_view port) const -> index_type
 {
-    return this->cache["device_cache"]["items"];
+    uint16_t port_number{};
+    auto [ptr, ec] = std::from_chars(port.data(), port.data() + port.size(), port_number);
+    if (ec != std::errc{})
+        return npos;
+
+    return find(ns3::Ipv4Address(std::string(ip).c_str()), port_number);
 }
 
-auto device_cache::view() -> value_type&
+auto device_cache::find_type(std::string_view device_type) const -> index_type
 {
-    return this->cache["device_cache"]["items"];
+    auto it = std::ranges::find(type_, device_type);
+    return it == type_.end() ? npos : static_cast<index_type>(it - type_.begin());
 }
 
 auto device_cache::size() const -> std::size_t
 {
-    return this->data().size();
+    return type_.size();
 }
 
 auto device_cache::empty() const -> bool
 {
-    return this->size() < 1;
+    return type_.empty();
+}
+
+auto device_cache::device_type(index_type index) const -> const std::string&
+{
+    return type_[index];
+}
+
+auto device_cache::address(index_type index) const -> ns3::Ipv4Address
+{
+    return ip_[index];
 }
 
-auto device_cache::emplace_back(attributes_type values) -> void
+auto device_cache::port(index_type index) const -> uint16_t
+{
+    return port_[index];
+}
+
+auto device_cache::position(index_type index) const -> const ns3::Vector&
+{
+    return position_[index];
+}
+
+auto device_cache::keys() const -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> result;
+    result.reserve(attributes_.size());
+    for (const auto& [key, column] : attributes_)
+        result.push_back(key);
+    return result;
+}
+
+auto device_cache::version(index_type index) const -> std::uint64_t
+{
+    return version_[index];
+}
+
+auto device_cache::set_version(index_type index, std::uint64_t version) -> void
+{
+    version_[index] = version;
+}
+
+auto device_cache::zone(index_type index) const -> std::uint32_t
+{
+    return zone_[index];
+}
+
+auto device_cache::set_zone(index_type index, std::uint32_t zone) -> void
+{
+    if (zone_[index] == zone)
+        return;
+
+    this->unindex_type_of(index);
+    zone_[index] = zone;
+    this->index_type_of(index);
+}
+
+auto device_cache::devices(std::string_view device_type) const -> std::span<const index_type>
+{
+    auto it = by_type_.find(device_type);
+    return it == by_type_.end() ? std::span<const index_type>{} : std::span<const index_type>{ it->second.all };
+}
+
+auto device_cache::devices(std::string_view device_type, std::uint32_t zone) const -> std::span<const index_type>
+{
+    auto it = by_type_.find(device_type);
+    if (it == by_type_.end())
+        return {};
+
+    auto z = it->second.zones.find(zone);
+    return z == it->second.zones.end() ? std::span<const index_type>{} : std::span<const index_type>{ z->second };
+}
+
+auto device_cache::index_type_of(index_type index) -> void
+{
+    auto it = by_type_.find(type_[index]);
+    if (it == by_type_.end())
+        it = by_type_.emplace(type_[index], type_index{}).first;
+    it->second.all.push_back(index);
+    it->second.zones[zone_[index]].push_back(index);
+}
+
+// 类型或区域变化很少发生，线性删除即可
+auto device_cache::unindex_type_of(index_type index) -> void
+{
+    auto it = by_type_.find(type_[index]);
+    if (it == by_type_.end())
+        return;
+
+    std::erase(it->second.all, index);
+    if (auto z = it->second.zones.find(zone_[index]); z != it->second.zones.end())
+        std::erase(z->second, index);
+}
+
+auto device_cache::get(index_type index, std::string_view key) const -> double
+{
+    auto it = attributes_.find(key);
+    return it == attributes_.end() ? std::numeric_limits<double>::quiet_NaN() : it->second.values[index];
+}
+
+auto device_cache::set(index_type index, std::string_view key, double value) -> void
+{
+    auto& column = column_for(key);
+    column.values[index] = value;
+    if (!column.text.empty())
+        column.text[index].clear();
+
+    for (auto& tracked : tracked_) {
+        if (tracked.key == key)
+            this->reindex(tracked, index);
+    }
+}
+
+auto device_cache::get_value(index_type index, std::string_view key) const -> std::string
+{
+    auto it = attributes_.find(key);
+    if (it == attributes_.end())
+        return {};
+
+    auto& column = it->second;
+    if (!std::isnan(column.values[index]))
+        return format_number(column.values[index]);
+    return column.text.empty() ? std::string{} : column.text[index];
+}
+
+auto device_cache::set_value(index_type index, std::string_view key, std::string_view value) -> void
+{
+    if (double number{}; parse_number(value, number))
+        return set(index, key, number);
+
+    auto& column = column_for(key);
+    if (column.text.empty())
+        column.text.resize(column.values.size());
+    column.values[index] = std::numeric_limits<double>::quiet_NaN();
+    column.text[index] = value;
+
+    for (auto& tracked : tracked_) {
+        if (tracked.key == key)
+            tracked.heap.erase(index);
+    }
+}
+
+auto device_cache::update(index_type index, const resource& res) -> void
+{
+    for (auto it = res.begin(); it != res.end(); ++it) {
+        if (it.value().is_number())
+            set(index, it.key(), it.value().get<double>());
+        else if (it.value().is_string())
+            set_value(index, it.key(), it.value().get_ref<const std::string&>());
+    }
+}
+
+auto device_cache::column(std::string_view key) const -> std::span<const double>
+{
+    auto it = attributes_.find(key);
+    return it == attributes_.end() ? std::span<const double>{} : std::span<const double>{ it->second.values };
+}
+
+auto device_cache::track(std::string_view key, std::string_view device_type) -> void
+{
+    if (std::ranges::any_of(tracked_, [&](const tracked_index& t) { return t.key == key && t.device_type == device_type; }))
+        return;
+
+    auto& tracked = tracked_.emplace_back(std::string(key), std::string(device_type));
+    for (index_type i = 0; i < this->size(); ++i)
+        this->reindex(tracked, i);
+}
+
+auto device_cache::argmax(std::string_view key, std::string_view device_type) const -> index_type
+{
+    for (const auto& tracked : tracked_) {
+        if (tracked.key == key && tracked.device_type == device_type)
+            return tracked.heap.top();
+    }
+
+    auto values = this->column(key);
+    auto result = npos;
+    for (index_type i = 0; i < values.size(); ++i) {
+        if (std::isnan(values[i]) || (!device_type.empty() && type_[i] != device_type))
+            continue;
+        if (result == npos || values[i] > values[result])
+            result = i;
+    }
+
+    return result;
+}
+
+auto device_cache::to_json(index_type index) const -> value_type
 {
     value_type item;
-    for (auto [key, value] : values) {
-        item[key] = value;
+    item["device_type"] = type_[index];
+    item["ip"] = okec::format("{:ip}", ip_[index]);
+    item["port"] = std::to_string(port_[index]);
+    item["pos_x"] = std::to_string(position_[index].x);
+    item["pos_y"] = std::to_string(position_[index].y);
+    item["pos_z"] = std::to_string(position_[index].z);
+    for (const auto& [key, column] : attributes_) {
+        if (!std::isnan(column.values[index]))
+            item[key] = format_number(column.values[index]);
+        else if (!column.text.empty() && !column.text[index].empty())
+            item[key] = column.text[index];
     }
 
-    this->emplace_back(std::move(item));
+    return item;
+}
+
+auto device_cache::view() const -> value_type
+{
+    value_type items = value_type::array();
+    for (index_type i = 0; i < this->size(); ++i)
+        items.push_back(this->to_json(i));
+    return items;
+}
+
+auto device_cache::data() const -> value_type
+{
+    return this->view();
+}
+
+auto device_cache::dump(int indent) const -> std::string
+{
+    value_type cache;
+    cache["device_cache"]["items"] = this->view();
+    return cache.dump(indent);
 }
 
-auto device_cache::find_if(unary_predicate_type pred) -> iterator
+auto device_cache::column_for(std::string_view key) -> attribute_column&
 {
-    auto& items = this->view();
-    return std::find_if(items.begin(), items.end(), pred);
+    auto it = attributes_.find(key);
+    if (it == attributes_.end()) {
+        it = attributes_.emplace(std::string(key), attribute_column{}).first;
+        it->second.values.resize(this->size(), std::numeric_limits<double>::quiet_NaN());
+    }
+
+    return it->second;
 }
 
-auto device_cache::sort(binary_predicate_type comp) -> void
+auto device_cache::reindex(index_type index) -> void
 {
-    auto& items = this->view();
-    std::sort(items.begin(), items.end(), comp);
+    for (auto& tracked : tracked_)
+        this->reindex(tracked, index);
 }
 
-auto device_cache::emplace_back(value_type item) -> void
+auto device_cache::reindex(tracked_index& tracked, index_type index) -> void
 {
-    this->cache["device_cache"]["items"].emplace_back(std::move(item));
+    auto value = this->get(index, tracked.key);
+    if (std::isnan(value) || (!tracked.device_type.empty() && type_[index] != tracked.device_type))
+        tracked.heap.erase(index);
+    else
+        tracked.heap.update(index, value);
 }
 
 auto decision_engine::resource_changed(edge_device* es,
-    ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void
+    ns3::Ipv4Address remote_ip, uint16_t remote_port, const task_id& settled) -> void
 {
     message notify_msg;
     notify_msg.type(message_resource_changed);
     notify_msg.attribute("ip", okec::format("{:ip}", es->get_address()));
     notify_msg.attribute("port", std::to_string(es->get_port()));
+    notify_msg.attribute("version", std::to_string(es->get_resource()->version()));
+    if (!settled.empty())
+        notify_msg.attribute("task_id", settled.to_string());
     notify_msg.content(*es->get_resource());
     es->write(notify_msg.to_packet(), remote_ip, remote_port);
 }
@@ -110,12 +379,314 @@ auto decision_engine::conflict(edge_device* es, const task_element& item, ns3::I
     message conflict_msg;
     conflict_msg.type(message_conflict);
     conflict_msg.content(item);
-    es->write(conflict_msg.to_packet(), remote_ip, remote_port);
+    auto packet = conflict_msg.to_packet();
+    m_stats.wasted_bytes += packet->GetSize();
+    es->write(packet, remote_ip, remote_port);
+}
+
+auto decision_engine::reserve(const task_id& id, device_cache::index_type index,
+    std::string_view key, double amount) -> std::uint64_t
+{
+    return this->reserve(id, index, demand_vector{ { std::string(key), amount } });
+}
+
+auto decision_engine::reserve(const task_id& id, device_cache::index_type index,
+    const demand_vector& demand) -> std::uint64_t
+{
+    ++m_stats.dispatched;
+    if (index == device_cache::npos)
+        return 0;
+
+    // 设备接受后每个属性的变化都会使版本加一，这里提前记上，同一批次的下一个预留基于新版本
+    auto version = m_device_cache.version(index);
+    m_device_cache.set_version(index, version + demand.size());
+    for (const auto& [key, amount] : demand)
+        m_device_cache.set(index, key, m_device_cache.get(index, key) - amount);
+    m_reservations.insert_or_assign(id, reservation{ index, demand });
+    return version;
+}
+
+auto decision_engine::settle(const task_id& id, bool restore) -> void
+{
+    auto it = m_reservations.find(id);
+    if (it == m_reservations.end())
+        return;
+
+    if (restore) {
+        const auto& [index, amounts] = it->second;
+        for (const auto& [key, amount] : amounts)
+            m_device_cache.set(index, key, m_device_cache.get(index, key) + amount);
+    }
+    m_reservations.erase(it);
+}
+
+auto decision_engine::on_resource_changed(base_station* bs, message& msg) -> void
+{
+    // 设备已扣除该任务的资源，预留随之失效
+    if (auto id = msg.get_value("task_id"); !id.empty()) {
+        auto settled = task_id::of(id);
+        settle(settled);
+        m_attempts.erase(settled);
+    }
+
+    // 更新资源信息，并重新扣除仍在途中的任务
+    if (auto index = m_device_cache.find(msg.get_value("ip"), msg.get_value("port")); index != device_cache::npos) {
+        m_device_cache.update(index, msg.get_resource());
+        auto version = msg.get_value("version");
+        if (!version.empty())
+            m_device_cache.set_version(index, std::stoull(version));
+        for (const auto& [id, r] : m_reservations) {
+            if (r.index == index) {
+                for (const auto& [key, amount] : r.amounts)
+                    m_device_cache.set(index, key, m_device_cache.get(index, key) - amount);
+                if (!version.empty())
+                    m_device_cache.set_version(index, m_device_cache.version(index) + r.amounts.size());
+            }
+        }
+    }
+
+    // 继续处理下一个任务的分发
+    bs->handle_next();
+}
+
+auto decision_engine::on_conflict(base_station* bs, message& msg) -> void
+{
+    auto id = msg.get_task_element().get_id();
+    settle(id, true);
+    this->unassign(id);
+    ++m_stats.conflicts;
+
+    // 指数退避后再放回待分发队列的最前面，期间任务保持在途状态，不会被再次分发
+    auto attempt = ++m_attempts[id];
+    auto delay = std::min(m_backoff_base.GetSeconds() * std::ldexp(1.0, static_cast<int>(std::min<std::size_t>(attempt, 32)) - 1),
+        m_backoff_max.GetSeconds());
+    if (!m_jitter)
+        m_jitter = ns3::CreateObject<ns3::UniformRandomVariable>();
+    delay = delay / 2 + m_jitter->GetValue(0.0, delay / 2);
+
+    log::warning("task({}) rejected, retry {} in {:.3f}s", id, attempt, delay);
+    ++m_stats.retries;
+    ns3::Simulator::Schedule(ns3::Seconds(delay), [self = shared_from_this(), bs, id]() {
+        if (bs->task_sequence().requeue(id))
+            bs->handle_next(); // 重新处理
+    });
+}
+
+auto decision_engine::admit(edge_device* es, message& msg, const task_element& item,
+    ns3::Ipv4Address remote_ip, uint16_t remote_port) -> bool
+{
+    return admit(es, msg, item, remote_ip, remote_port, "cpu", item.get_cpu());
+}
+
+auto decision_engine::admit(edge_device* es, message& msg, const task_element& item,
+    ns3::Ipv4Address remote_ip, uint16_t remote_port, std::string_view key, double demand) -> bool
+{
+    return admit(es, msg, item, remote_ip, remote_port, demand_vector{ { std::string(key), demand } });
+}
+
+auto decision_engine::admit(edge_device* es, message& msg, const task_element& item,
+    ns3::Ipv4Address remote_ip, uint16_t remote_port, const demand_vector& demand) -> bool
+{
+    auto es_resource = es->get_resource();
+    auto current = es_resource->version();
+
+    // 预留所基于的版本，缺失或格式错误时只按容量判断
+    std::optional<std::uint64_t> expected;
+    if (auto text = msg.get_value("version"); !text.empty()) {
+        std::uint64_t v{};
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), v);
+        if (ec == std::errc{} && ptr == text.data() + text.size())
+            expected = v;
+    }
+
+    // A reservation made against the current version (or a later one, when
+    // an earlier task of the same batch was turned down) was decided on
+    // what the device has now. Against an older version, the capacity it
+    // relied on minus what other tasks took since must still cover the
+    // demand; capacity released after the decision does not count, and if
+    // the changes since that version are unknown the reservation fails.
+    auto covered = [&](const std::pair<std::string, double>& d) {
+        auto supply = es_resource->get_number(d.first);
+        if (!expected || *expected >= current)
+            return supply >= d.second;
+        auto drift = es_resource->drift_since(*expected, d.first);
+        return drift && supply - drift->released >= d.second;
+    };
+
+    auto short_of = std::ranges::find_if_not(demand, covered);
+    if (short_of == demand.end()) {
+        if (expected && *expected < current)
+            ++m_stats.stale_accepts;
+        return true;
+    }
+
+    log::error("Conflict! task({}) {}_demand: {}, real_supply: {}, version: {} (expected {}).",
+        item.get_id(), short_of->first, short_of->second, es_resource->get_number(short_of->first), current, msg.get_value("version"));
+    m_stats.wasted_bytes += msg.wire_size();
+    this->conflict(es, item, remote_ip, remote_port);
+    return false;
+}
+
+auto decision_engine::forward(const task_element& item) -> bool
+{
+    if (m_peers.empty() || !item.get_header("forwarded").empty())
+        return false;
+
+    auto cpu_demand = item.get_cpu();
+    auto best = std::ranges::max_element(m_peers, {}, &peer_state::max_cpu);
+    if (best->max_cpu < cpu_demand)
+        return false;
+
+    // 在下一次摘要到达前先扣掉，避免把一批任务都转发给同一个分片
+    best->max_cpu -= cpu_demand;
+    best->total_cpu -= cpu_demand;
+
+    auto id = item.get_id();
+    auto forwarded = item;
+    forwarded.set_header("forwarded", "1");
+    message msg;
+    msg.type(message_decision);
+    msg.content(forwarded);
+    m_decision_device->write(msg.to_packet(), best->bs->get_address(), best->bs->get_port());
+    m_decision_device->task_sequence().erase(id);
+    this->unassign(id);
+    ++m_stats.forwarded;
+
+    log::info("task({}) forwarded to base station({:ip})", id, best->bs->get_address());
+    return true;
+}
+
+auto decision_engine::add_peer(std::shared_ptr<base_station> peer) -> void
+{
+    if (m_peers.empty()) {
+        m_decision_device->set_request_handler(message_capacity_summary,
+            [this](okec::base_station* bs, message& msg, const ns3::Address& remote_address) {
+                auto ip = ns3::Ipv4Address(msg.get_value("ip").c_str());
+                auto port = static_cast<uint16_t>(std::stoi(msg.get_value("port")));
+                for (auto& peer : m_peers) {
+                    if (peer.bs->get_address() == ip && peer.bs->get_port() == port) {
+                        peer.max_cpu = std::stod(msg.get_value("max_cpu"));
+                        peer.total_cpu = std::stod(msg.get_value("total_cpu"));
+                        break;
+                    }
+                }
+            });
+    }
+
+    m_peers.push_back(peer_state{ .bs = std::move(peer) });
+}
+
+auto decision_engine::publish_summary() -> void
+{
+    double max_cpu = 0.0;
+    double total_cpu = 0.0;
+    auto cpu = m_device_cache.column("cpu");
+    for (device_cache::index_type i = 0; i < cpu.size(); ++i) {
+        if (m_device_cache.device_type(i) == "es" && !std::isnan(cpu[i])) {
+            max_cpu = std::max(max_cpu, cpu[i]);
+            total_cpu += std::max(cpu[i], 0.0);
+        }
+    }
+
+    message msg {
+        { "msgtype", message_capacity_summary },
+        { "ip", okec::format("{:ip}", m_decision_device->get_address()) },
+        { "port", std::to_string(m_decision_device->get_port()) },
+        { "max_cpu", okec::format("{}", max_cpu) },
+        { "total_cpu", okec::format("{}", total_cpu) }
+    };
+    for (const auto& peer : m_peers)
+        m_decision_device->write(msg.to_packet(), peer.bs->get_address(), peer.bs->get_port());
+}
+
+auto decision_engine::estimate_finish(const task_element& item, const task_queue& queue) -> double
+{
+    double max_capacity = 0.0;
+    double total_capacity = 0.0;
+    auto cpu = m_device_cache.column("cpu");
+    if (m_capacity.size() < cpu.size())
+        m_capacity.resize(cpu.size(), 0.0);
+    for (device_cache::index_type i = 0; i < cpu.size(); ++i) {
+        if (m_device_cache.device_type(i) == "es" && !std::isnan(cpu[i])) {
+            m_capacity[i] = std::max(m_capacity[i], cpu[i]);
+            max_capacity = std::max(max_capacity, m_capacity[i]);
+            total_capacity += m_capacity[i];
+        }
+    }
+
+    if (max_capacity <= 0.0)
+        return std::numeric_limits<double>::infinity();
+
+    // item 尚未入队时，work_ahead 不含它自己的需求
+    auto demand = item.get_cpu();
+    auto ahead = queue.work_ahead(item);
+    if (!queue.contains(item.get_id()))
+        ahead += demand;
+
+    return okec::now::seconds() + std::max(ahead / total_capacity, demand / max_capacity);
+}
+
+auto decision_engine::admit_deadline(const task_element& item, const task_queue& queue) -> bool
+{
+    auto deadline = task_queue::absolute_deadline(item);
+    if (std::isinf(deadline))
+        return true;
+
+    if (m_admission_control && this->estimate_finish(item, queue) > deadline)
+        return false;
+
+    ++m_deadlines.admitted;
+    return true;
+}
+
+auto decision_engine::expired(const task_element& item) const -> bool
+{
+    return m_admission_control && okec::now::seconds() > task_queue::absolute_deadline(item);
+}
+
+auto decision_engine::record_completion(const task_element& item) -> void
+{
+    auto deadline = task_queue::absolute_deadline(item);
+    if (std::isinf(deadline))
+        return;
+
+    if (okec::now::seconds() <= deadline)
+        ++m_deadlines.met;
+    else
+        ++m_deadlines.missed;
+}
+
+auto decision_engine::reject(const task_element& item, std::string_view reason) -> void
+{
+    auto from_ip = item.get_header("from_ip");
+    auto from_port = item.get_header("from_port");
+    if (!from_ip.empty() && !from_port.empty()) {
+        message response {
+            { "msgtype", "response" },
+            { "task_id", item.get_id().to_string() },
+            { "group", item.get_group() },
+            { "device_type", "null" },
+            { "device_address", "N/A" },
+            { "processing_time", "N/A" }
+        };
+        m_decision_device->write(response.to_packet(), ns3::Ipv4Address(from_ip.c_str()),
+            static_cast<uint16_t>(std::stoi(from_port)));
+    }
+
+    if (reason == "expired")
+        ++m_deadlines.expired;
+    else
+        ++m_deadlines.rejected;
+
+    log::warning("task({}) {}: deadline {:.3f}s cannot be met", item.get_id(), reason, task_queue::absolute_deadline(item));
+    auto id = item.get_id(); // item 可能就在队列中
+    m_decision_device->task_sequence().erase(id);
+    this->unassign(id);
 }
 
 auto decision_engine::calculate_distance(const ns3::Vector& pos) -> double
 {
-    ns3::Vector this_pos = m_decision_device->get_position();
+    ns3::Vector this_pos = m_decision_device ? m_decision_device->get_position() : m_decision_position;
     double delta_x = this_pos.x - pos.x;
     double delta_y = this_pos.y - pos.y;
     double delta_z = this_pos.z - pos.z;
@@ -123,9 +694,14 @@ auto decision_engine::calculate_distance(const ns3::Vector& pos) -> double
     return std::sqrt(delta_x * delta_x + delta_y * delta_y + delta_z * delta_z);
 }
 
+auto decision_engine::set_decision_position(const ns3::Vector& pos) -> void
+{
+    m_decision_position = pos;
+}
+
 auto decision_engine::calculate_distance(double x, double y, double z) -> double
 {
-    ns3::Vector this_pos = m_decision_device->get_position();
+    ns3::Vector this_pos = m_decision_device ? m_decision_device->get_position() : m_decision_position;
     double delta_x = this_pos.x - x;
     double delta_y = this_pos.y - y;
     double delta_z = this_pos.z - z;
@@ -139,30 +715,20 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
     if (!m_decision_device)
         m_decision_device = bs_container->get(0);
 
+    // worst-fit 类策略按剩余 CPU 选择设备
+    m_device_cache.track("cpu");
+    m_device_cache.track("cpu", "es");
+
     // 记录云服务器信息
     if (cs) {
         auto cs_pos = cs->get_position();
         auto cs_res = cs->get_resource();
 
         if (cs_res && !cs_res->empty()) {
-            m_device_cache.emplace_back({
-                { "device_type", "cs" },
-                { "ip", okec::format("{:ip}", cs->get_address()) },
-                { "port", std::to_string(cs->get_port()) },
-                { "pos_x", std::to_string(cs_pos.x) },
-                { "pos_y", std::to_string(cs_pos.y) },
-                { "pos_z", std::to_string(cs_pos.z) }
-            });
+            auto index = m_device_cache.emplace("cs", cs->get_address(), cs->get_port(), cs_pos);
+            m_device_cache.update(index, *cs_res);
 
-            auto find_pred = [](const device_cache::value_type& item) {
-                return item["device_type"] == "cs";
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end())
-                for (auto it = cs_res->begin(); it != cs_res->end(); ++it)
-                    (*item)[it.key()] = it.value();
-
-            log::debug("The decision engine got the resource information of cloud({}).", (*item)["ip"].template get<std::string>());
+            log::debug("The decision engine got the resource information of cloud({:ip}).", cs->get_address());
         } else {
             // 说明设备此时还未绑定资源，通过网络询问一下
             ns3::Simulator::Schedule(ns3::Seconds(1.0), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
@@ -175,38 +741,21 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
 
     // 记录边缘服务器信息
     double delay = 1.0;
+    std::uint32_t zone = 0; // 边缘服务器所连接的基站序号
     std::for_each(bs_container->begin(), bs_container->end(),
-    [&delay, this](const base_station_container::pointer_t bs) {
+    [&delay, &zone, this](const base_station_container::pointer_t bs) {
         for (const auto& device : bs->get_edge_devices()) {
             auto p_resource = device->get_resource();
 
             // 动态记录资源信息
             if (p_resource && !p_resource->empty()) {
                 // 设备已经绑定资源，直接记录
-                auto es_pos = device->get_position();
-                auto ip = okec::format("{:ip}", device->get_address());
-                auto port = std::to_string(device->get_port());
-
-                m_device_cache.emplace_back({
-                    { "device_type", "es" },
-                    { "ip", ip },
-                    { "port", port },
-                    { "pos_x", std::to_string(es_pos.x) },
-                    { "pos_y", std::to_string(es_pos.y) },
-                    { "pos_z", std::to_string(es_pos.z) }
-                });
-
-                auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                    return item["ip"] == ip && item["port"] == port;
-                };
-                auto item = m_device_cache.find_if(find_pred);
-                if (item != m_device_cache.end()) {
-                    for (auto it = p_resource->begin(); it != p_resource->end(); ++it) {
-                        (*item)[it.key()] = it.value();
-                    }
-                }
+                auto index = m_device_cache.emplace("es", device->get_address(), device->get_port(), device->get_position());
+                m_device_cache.update(index, *p_resource);
+                m_device_cache.set_version(index, p_resource->version());
+                m_device_cache.set_zone(index, zone);
 
-                log::debug("The decision engine got the resource information of edge device({}).", (*item)["ip"].template get<std::string>());
+                log::debug("The decision engine got the resource information of edge device({:ip}).", device->get_address());
             } else {
                 // 说明设备此时还未绑定资源，通过网络询问一下
                 ns3::Simulator::Schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
@@ -215,79 +764,44 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
                     socket->write(msg.to_packet(), ip, port);
                 }, this->m_decision_device, device->get_address(), device->get_port());
                 delay += 0.1;
+                m_pending_zones.insert_or_assign(static_cast<std::uint64_t>(device->get_address().Get()) << 16 | device->get_port(), zone);
             }
         }
+        ++zone;
     });
 
     // okec::print("Info: {}\n", m_device_cache.dump());
 
     // 捕获通过网络问询的信息，更新设备信息（能收到就一定存在资源信息）
     m_decision_device->set_request_handler(message_resource_information, 
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            log::debug("The decision engine has received device resource information: {}", okec::packet_helper::to_string(packet));
+        [this](okec::base_station* bs, message& msg, const ns3::Address& remote_address) {
+            if (log::level_debug_enabled)
+                log::debug("The decision engine has received device resource information: {}", msg.dump());
 
-            auto msg = message::from_packet(packet);
-            auto es_resource = resource::from_msg_packet(packet);
             auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            m_device_cache.emplace_back({
-                { "device_type", msg.get_value("device_type") },
-                { "ip", ip },
-                { "port", port },
-                { "pos_x", msg.get_value("pos_x") },
-                { "pos_y", msg.get_value("pos_y") },
-                { "pos_z", msg.get_value("pos_z") }
-            });
-
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
-            }
+            auto index = m_device_cache.emplace(msg.get_value("device_type"),
+                ns3::Ipv4Address(ip.c_str()), static_cast<uint16_t>(std::stoi(msg.get_value("port"))),
+                ns3::Vector(std::stod(msg.get_value("pos_x")), std::stod(msg.get_value("pos_y")), std::stod(msg.get_value("pos_z"))));
+
+            m_device_cache.update(index, msg.get_resource());
+            if (auto version = msg.get_value("version"); !version.empty())
+                m_device_cache.set_version(index, std::stoull(version));
+            if (auto zone = m_pending_zones.find(static_cast<std::uint64_t>(m_device_cache.address(index).Get()) << 16 | m_device_cache.port(index));
+                zone != m_pending_zones.end())
+                m_device_cache.set_zone(index, zone->second);
         });
 
     // 捕获资源变化信息
     // 资源更新(外部所指定的BS不一定是第0个，所以要为所有BS设置消息以确保捕获)
     bs_container->set_request_handler(message_resource_changed, 
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            // okec::print("At time {:.2f}s The decision engine got notified about device resource changes: {}\n", Simulator::Now().GetSeconds() , okec::packet_helper::to_string(packet));
-            auto msg = message::from_packet(packet);
-            auto es_resource = resource::from_msg_packet(packet);
-            auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            // 更新资源信息
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
-            }
-
-            // 继续处理下一个任务的分发
-            bs->handle_next();
+        [this](okec::base_station* bs, message& msg, const ns3::Address& remote_address) {
+            this->on_resource_changed(bs, msg);
         });
 
     // 捕获资源冲突问题
     bs_container->set_request_handler(message_conflict,
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            auto task_item = task_element::from_msg_packet(packet);
-            auto& task_sequence = bs->task_sequence();
-            if (auto it = std::ranges::find_if(task_sequence, [&task_item](auto const& item) {
-                return item.get_header("task_id") == task_item.get_header("task_id");
-            }); it != std::end(task_sequence)) {
-                // okec::print("找到了 {} status: {}\n", (*it).get_header("task_id"), (*it).get_header("status"));
-                (*it).set_header("status", "0");
-                bs->handle_next(); // 重新处理
-            }
+        [this](okec::base_station* bs, message& msg, const ns3::Address& remote_address) {
+            this->on_conflict(bs, msg);
         });
 }
 
@@ -297,40 +811,27 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
     if (!m_decision_device)
         m_decision_device = bs_container->get(0);
 
+    // worst-fit 类策略按剩余 CPU 选择设备
+    m_device_cache.track("cpu");
+    m_device_cache.track("cpu", "es");
+
     // 记录边缘服务器信息
     double delay = 1.0;
+    std::uint32_t zone = 0; // 边缘服务器所连接的基站序号
     std::for_each(bs_container->begin(), bs_container->end(),
-    [&delay, this](const base_station_container::pointer_t bs) {
+    [&delay, &zone, this](const base_station_container::pointer_t bs) {
         for (const auto& device : bs->get_edge_devices()) {
             auto p_resource = device->get_resource();
 
             // 动态记录资源信息
             if (p_resource && !p_resource->empty()) {
                 // 设备已经绑定资源，直接记录
-                auto es_pos = device->get_position();
-                auto ip = okec::format("{:ip}", device->get_address());
-                auto port = std::to_string(device->get_port());
-
-                m_device_cache.emplace_back({
-                    { "device_type", "es" },
-                    { "ip", ip },
-                    { "port", port },
-                    { "pos_x", std::to_string(es_pos.x) },
-                    { "pos_y", std::to_string(es_pos.y) },
-                    { "pos_z", std::to_string(es_pos.z) }
-                });
-
-                auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                    return item["ip"] == ip && item["port"] == port;
-                };
-                auto item = m_device_cache.find_if(find_pred);
-                if (item != m_device_cache.end()) {
-                    for (auto it = p_resource->begin(); it != p_resource->end(); ++it) {
-                        (*item)[it.key()] = it.value();
-                    }
-                }
+                auto index = m_device_cache.emplace("es", device->get_address(), device->get_port(), device->get_position());
+                m_device_cache.update(index, *p_resource);
+                m_device_cache.set_version(index, p_resource->version());
+                m_device_cache.set_zone(index, zone);
 
-                log::debug("The decision engine received resource information from edge server({}).", (*item)["ip"].template get<std::string>());
+                log::debug("The decision engine received resource information from edge server({:ip}).", device->get_address());
             } else {
                 // 说明设备此时还未绑定资源，通过网络询问一下
                 ns3::Simulator::Schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
@@ -339,87 +840,164 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
                     socket->write(msg.to_packet(), ip, port);
                 }, this->m_decision_device, device->get_address(), device->get_port());
                 delay += 0.1;
+                m_pending_zones.insert_or_assign(static_cast<std::uint64_t>(device->get_address().Get()) << 16 | device->get_port(), zone);
             }
         }
+        ++zone;
     });
 
     // okec::print("Info: {}\n", m_device_cache.dump());
 
     // 捕获通过网络问询的信息，更新设备信息（能收到就一定存在资源信息）
     m_decision_device->set_request_handler(message_resource_information, 
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            log::debug("The decision engine has received device resource information: {}", okec::packet_helper::to_string(packet));
-            
-            auto msg = message::from_packet(packet);
-            auto es_resource = resource::from_msg_packet(packet);
-            auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            m_device_cache.emplace_back({
-                { "device_type", msg.get_value("device_type") },
-                { "ip", ip },
-                { "port", port },
-                { "pos_x", msg.get_value("pos_x") },
-                { "pos_y", msg.get_value("pos_y") },
-                { "pos_z", msg.get_value("pos_z") }
-            });
+        [this](okec::base_station* bs, message& msg, const ns3::Address& remote_address) {
+            if (log::level_debug_enabled)
+                log::debug("The decision engine has received device resource information: {}", msg.dump());
 
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
-            }
+            auto ip = msg.get_value("ip");
+            auto index = m_device_cache.emplace(msg.get_value("device_type"),
+                ns3::Ipv4Address(ip.c_str()), static_cast<uint16_t>(std::stoi(msg.get_value("port"))),
+                ns3::Vector(std::stod(msg.get_value("pos_x")), std::stod(msg.get_value("pos_y")), std::stod(msg.get_value("pos_z"))));
+
+            m_device_cache.update(index, msg.get_resource());
+            if (auto version = msg.get_value("version"); !version.empty())
+                m_device_cache.set_version(index, std::stoull(version));
+            if (auto zone = m_pending_zones.find(static_cast<std::uint64_t>(m_device_cache.address(index).Get()) << 16 | m_device_cache.port(index));
+                zone != m_pending_zones.end())
+                m_device_cache.set_zone(index, zone->second);
         });
 
     // 捕获资源变化信息
     // 资源更新(外部所指定的BS不一定是第0个，所以要为所有BS设置消息以确保捕获)
     bs_container->set_request_handler(message_resource_changed, 
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            // okec::print("At time {:.2f}s The decision engine got notified about device resource changes: {}\n", Simulator::Now().GetSeconds() , okec::packet_helper::to_string(packet));
-            auto msg = message::from_packet(packet);
-            auto es_resource = resource::from_msg_packet(packet);
-            auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            // 更新资源信息
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
-            }
-
-            // 继续处理下一个任务的分发
-            bs->handle_next();
+        [this](okec::base_station* bs, message& msg, const ns3::Address& remote_address) {
+            this->on_resource_changed(bs, msg);
         });
 
     // 捕获资源冲突问题
     bs_container->set_request_handler(message_conflict,
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            auto task_item = task_element::from_msg_packet(packet);
-            auto& task_sequence = bs->task_sequence();
-            if (auto it = std::ranges::find_if(task_sequence, [&task_item](auto const& item) {
-                return item.get_header("task_id") == task_item.get_header("task_id");
-            }); it != std::end(task_sequence)) {
-                // okec::print("找到了 {} status: {}\n", (*it).get_header("task_id"), (*it).get_header("status"));
-                (*it).set_header("status", "0");
-                bs->handle_next(); // 重新处理
-            }
+        [this](okec::base_station* bs, message& msg, const ns3::Address& remote_address) {
+            this->on_conflict(bs, msg);
         });
 }
 
+auto decision_engine::decide(const task_element& header) -> device_cache::index_type
+{
+    auto target = this->make_decision(header);
+    if (target.is_null())
+        return device_cache::npos;
+    return m_device_cache.find(TO_STR(target["ip"]), TO_STR(target["port"]));
+}
+
+auto decision_engine::initialize() -> void
+{
+    if (m_clients)
+        m_clients->set_decision_engine(shared_from_this());
+
+    if (m_clients_container) {
+        for (auto& clients : *m_clients_container)
+            clients.set_decision_engine(shared_from_this());
+    }
+
+    if (m_base_stations)
+        m_base_stations->set_decision_engine(shared_from_this());
+}
+
+auto decision_engine::attach(client_device_container* clients, base_station_container* base_stations) -> void
+{
+    m_clients = clients;
+    m_base_stations = base_stations;
+    if (!m_decision_device && base_stations->size() > 0uz)
+        m_decision_device = base_stations->get(0);
+
+    clients->set_request_handler(message_response, std::bind_front(&decision_engine::on_clients_response_message, this));
+}
+
+auto decision_engine::attach(std::vector<client_device_container>* clients_container, base_station_container* base_stations) -> void
+{
+    m_clients_container = clients_container;
+    m_base_stations = base_stations;
+    if (!m_decision_device && base_stations->size() > 0uz)
+        m_decision_device = base_stations->get(0);
+
+    for (auto& clients : *clients_container)
+        clients.set_request_handler(message_response, std::bind_front(&decision_engine::on_clients_response_message, this));
+}
+
+auto decision_engine::on_clients_response_message(client_device* client, message& msg, const ns3::Address& remote_address) -> void
+{
+    auto& responses = client->response_cache();
+    auto group = msg.get_value("group");
+    auto id = task_id::of(msg.get_value("task_id"));
+
+    if (auto it = responses.find(id); it && (*it)["group"] == group) {
+        this->fill_response(*it, msg);
+        responses.finish(id, msg.get_value("device_type") != "null" ? "Y" : "N");
+
+        log::success("client({:ip}) has received a response for task(id={}).", client->get_address(), msg.get_value("task_id"));
+    }
+
+    // 检查是否存在当前任务的信息
+    if (!responses.contains(group)) {
+        log::error("Fatal error! Invalid response."); // 说明发出去的数据被修改，或是 m_response 被无意间删除了信息
+        return;
+    }
+
+    // 全部完成
+    if (responses.outstanding(group) == 0) {
+        auto token = responses.token(group);
+        client->when_done(token, responses.take(group));
+    }
+}
+
+auto decision_engine::fill_response(json& row, message& msg) -> void
+{
+    row["device_type"] = msg.get_value("device_type");
+    row["device_address"] = msg.get_value("device_address");
+    row["time_consuming"] = msg.get_value("processing_time");
+}
+
 auto decision_engine::get_decision_device() const -> std::shared_ptr<base_station>
 {
     return m_decision_device;
 }
 
+auto decision_engine::set_batch_size(std::size_t k) -> void
+{
+    m_batch_size = std::max<std::size_t>(k, 1);
+}
+
+auto decision_engine::batch_size() const -> std::size_t
+{
+    return m_batch_size;
+}
+
+auto decision_engine::set_retry_backoff(ns3::Time base, ns3::Time max) -> void
+{
+    m_backoff_base = base;
+    m_backoff_max = max;
+}
+
+auto decision_engine::stats() const -> const dispatch_stats&
+{
+    return m_stats;
+}
+
+auto decision_engine::set_admission_control(bool enable) -> void
+{
+    m_admission_control = enable;
+}
+
+auto decision_engine::admission_control() const -> bool
+{
+    return m_admission_control;
+}
+
+auto decision_engine::deadlines() const -> const deadline_stats&
+{
+    return m_deadlines;
+}
+
 auto decision_engine::cache() -> device_cache&
 {
     return m_device_cache;
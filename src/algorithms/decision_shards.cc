@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/algorithms/decision_shards.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/log.h>
+
+
+namespace okec
+{
+
+decision_shards::decision_shards(simulator& sim, std::vector<client_device_container>& clients,
+    base_station_container& base_stations, factory_type factory)
+    : sim_{ sim }
+{
+    if (clients.size() != base_stations.size()) {
+        log::error("decision_shards: {} client groups for {} base stations!", clients.size(), base_stations.size());
+        return;
+    }
+
+    engines_.reserve(base_stations.size());
+    for (std::size_t i = 0; i < base_stations.size(); ++i) {
+        auto& shard = base_stations_.emplace_back(std::vector{ base_stations.get(i) });
+        engines_.push_back(factory(&clients[i], &shard));
+    }
+}
+
+decision_shards::~decision_shards()
+{
+    event_.Cancel();
+}
+
+auto decision_shards::initialize() -> void
+{
+    for (std::size_t i = 0; i < engines_.size(); ++i) {
+        engines_[i]->initialize();
+        for (std::size_t j = 0; j < engines_.size(); ++j) {
+            if (i != j)
+                engines_[i]->add_peer(base_stations_[j].get(0));
+        }
+    }
+
+    event_.Cancel();
+    if (engines_.size() > 1)
+        event_ = ns3::Simulator::Schedule(interval_, &decision_shards::publish, this);
+}
+
+auto decision_shards::set_summary_interval(ns3::Time interval) -> decision_shards&
+{
+    interval_ = interval;
+    return *this;
+}
+
+auto decision_shards::size() const -> std::size_t
+{
+    return engines_.size();
+}
+
+auto decision_shards::get(std::size_t index) const -> std::shared_ptr<decision_engine>
+{
+    return engines_.at(index);
+}
+
+auto decision_shards::stats() const -> dispatch_stats
+{
+    dispatch_stats total;
+    for (const auto& engine : engines_) {
+        const auto& s = engine->stats();
+        total.dispatched += s.dispatched;
+        total.conflicts += s.conflicts;
+        total.retries += s.retries;
+        total.stale_accepts += s.stale_accepts;
+        total.wasted_bytes += s.wasted_bytes;
+        total.forwarded += s.forwarded;
+    }
+    return total;
+}
+
+auto decision_shards::publish() -> void
+{
+    for (auto& engine : engines_)
+        engine->publish_summary();
+
+    // 仿真结束后不再交换摘要
+    if (ns3::Simulator::Now() + interval_ <= sim_.stop_time())
+        event_ = ns3::Simulator::Schedule(interval_, &decision_shards::publish, this);
+}
+
+} // namespace okec
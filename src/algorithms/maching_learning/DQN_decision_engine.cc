@@ -9,6 +9,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/algorithms/machine_learning/DQN_decision_engine.h>
+#include <okec/common/arrival_process.h>
 #include <okec/common/message.h>
 #include <okec/devices/base_station.h>
 #include <okec/devices/client_device.h>
@@ -29,7 +30,7 @@ Env::Env(const device_cache& cache, const task& t, std::shared_ptr<DeepQNetwork>
 {
     // 先为所有任务设置处理标识
     for (auto& t : t_.elements_view()) {
-        t.set_header("status", "0"); // 0: 未处理 1: 已处理
+        t.set_status(0); // 0: 未处理 1: 已处理
     }
 
     // observation_ = next_observation();
@@ -47,15 +48,12 @@ auto Env::next_observation() -> torch::Tensor
 {
     auto task_elements = this->t_.elements_view();
     if (auto it = std::ranges::find_if(task_elements, [](auto const& item) {
-        return item.get_header("status") == "0";
+        return item.get_status() == 0;
     }); it != std::end(task_elements)) {
-        auto& edge_cache = this->cache_.view();
-        std::vector<double> flattened_state;
-        for (const auto& edge : edge_cache) {
-            flattened_state.push_back(TO_DOUBLE(edge["cpu"]));
-        }
+        auto cpu = this->cache_.column("cpu");
+        std::vector<double> flattened_state(cpu.begin(), cpu.end());
 
-        flattened_state.push_back(std::stod((it)->get_header("cpu")));
+        flattened_state.push_back((it)->get_cpu());
         return torch::tensor(flattened_state, torch::dtype(torch::kFloat64)).unsqueeze(0);
     }
 
@@ -79,11 +77,9 @@ auto Env::train_next(torch::Tensor observation) -> void
     float reward;
     auto task_elements = t_.elements_view();
     if (auto it = std::ranges::find_if(task_elements, [](auto const& item) {
-        return item.get_header("status") == "0";
+        return item.get_status() == 0;
     }); it != std::end(task_elements)) {
-        auto& edge_cache = cache_.view();
         auto action = RL_->choose_action(observation);
-        auto& server = edge_cache.at(action);
         // okec::print("choose action: {}\n", action);
         // okec::print("server:\n{}\n", server.dump(4));
 
@@ -91,20 +87,19 @@ auto Env::train_next(torch::Tensor observation) -> void
         float alpha = 0.8; // 6/4
         float beta = 0.2; // 9/1 出现过23 8/2 也是
 
-        auto cpu_supply = TO_DOUBLE(server["cpu"]);
-        auto cpu_demand = std::stod(it->get_header("cpu"));
+        auto cpu_supply = cache_.get(action, "cpu");
+        auto cpu_demand = it->get_cpu();
 
         // 计算平均处理时间
         std::vector<double> time;
-        for (const auto& edge : edge_cache) {
-            double e_supply = TO_DOUBLE(edge["cpu"]);
+        for (double e_supply : cache_.column("cpu")) {
             if (e_supply != 0)
                 time.push_back(cpu_demand / e_supply);
         }
         double average_processing_time = std::accumulate(time.begin(), time.end(), .0) / time.size();
         double processing_time;
 
-        // okec::print("正在处理 {}, supply: {}, demand: {}\n", it->get_header("task_id"), cpu_supply, cpu_demand);
+        // okec::print("正在处理 {}, supply: {}, demand: {}\n", it->get_id(), cpu_supply, cpu_demand);
 
         if (cpu_supply < cpu_demand) { // 无法处理
             processing_time = cpu_demand / cpu_supply;
@@ -119,12 +114,12 @@ auto Env::train_next(torch::Tensor observation) -> void
         } else { // 可以处理
             processing_time = cpu_demand / cpu_supply;
             double new_cpu = cpu_supply - cpu_demand;
-            it->set_header("status", "1");
+            it->set_status(1);
             it->set_header("processing_time", std::to_string(processing_time));
 
             // 消耗资源
-            server["cpu"] = std::to_string(new_cpu);
-            // okec::print("[{}] 消耗资源：{} --> {}\n", TO_STR(server["ip"]), cpu_supply, TO_DOUBLE(server["cpu"]));
+            cache_.set(action, "cpu", new_cpu);
+            // okec::print("[{:ip}] 消耗资源：{} --> {}\n", cache_.address(action), cpu_supply, new_cpu);
 
             this->trace_resource();
 
@@ -135,11 +130,9 @@ auto Env::train_next(torch::Tensor observation) -> void
             // 资源恢复
             auto self = shared_from_this();
             ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, action, cpu_demand, alpha, beta, average_processing_time]() {
-                auto& edge_cache = self->cache_.view();
-                auto& server = edge_cache.at(action);
-                double cur_cpu = TO_DOUBLE(server["cpu"]);
+                double cur_cpu = self->cache_.get(action, "cpu");
                 double new_cpu = cur_cpu + cpu_demand;
-                // okec::format("[{}] 恢复资源：{} --> {:.2f}(demand: {})", TO_STR(server["ip"]), cur_cpu, new_cpu, cpu_demand);
+                // okec::format("[{:ip}] 恢复资源：{} --> {:.2f}(demand: {})", self->cache_.address(action), cur_cpu, new_cpu, cpu_demand);
                 
                 // 恢复资源
                 float reward;
@@ -147,7 +140,7 @@ auto Env::train_next(torch::Tensor observation) -> void
                 // self->t_.print();
 
                 auto observation = self->next_observation();
-                server["cpu"] = std::to_string(new_cpu);
+                self->cache_.set(action, "cpu", new_cpu);
 
                 self->trace_resource();
 
@@ -237,9 +230,8 @@ auto Env::trace_resource(int flag) -> void
     // }
     // file << "\n";
     file << okec::format("{:.2f} [episode={}]", ns3::Simulator::Now().GetSeconds(), episode);
-    auto& edge_cache = this->cache_.view();
-    for (const auto& edge : edge_cache) {
-        file << "," << TO_DOUBLE(edge["cpu"]);
+    for (auto cpu : this->cache_.column("cpu")) {
+        file << "," << cpu;
     }
     file << "\n";
 }
@@ -247,12 +239,9 @@ auto Env::trace_resource(int flag) -> void
 DQN_decision_engine::DQN_decision_engine(
     client_device_container* clients,
     base_station_container* base_stations)
-    : clients_{clients}
-    , base_stations_{base_stations}
 {
-    // Set the decision device
-    if (base_stations->size() > 0uz)
-        m_decision_device = base_stations->get(0);
+    // Set the decision device and capture the response message on client devices.
+    this->attach(clients, base_stations);
 
     // Initialize the device cache
     this->initialize_device(base_stations);
@@ -263,20 +252,14 @@ DQN_decision_engine::DQN_decision_engine(
 
     // Capture the handling message on edge servers
     base_stations->set_es_request_handler(message_handling, std::bind_front(&this_type::on_es_handling_message, this));
-
-    // Capture the response message on client devices.
-    clients->set_request_handler(message_response, std::bind_front(&this_type::on_clients_reponse_message, this));
 }
 
 DQN_decision_engine::DQN_decision_engine(
     std::vector<client_device_container>* clients_container,
     base_station_container* base_stations)
-    : clients_container_{clients_container}
-    , base_stations_{base_stations}
 {
-    // Set the decision device
-    if (base_stations->size() > 0uz)
-        m_decision_device = base_stations->get(0);
+    // Set the decision device and capture the response message on client devices.
+    this->attach(clients_container, base_stations);
 
     // Initialize the device cache
     this->initialize_device(base_stations);
@@ -288,11 +271,6 @@ DQN_decision_engine::DQN_decision_engine(
     // Capture the handling message on edge servers
     base_stations->set_es_request_handler(message_handling, std::bind_front(&this_type::on_es_handling_message, this));
 
-    // Capture the response message on client devices.
-    for (auto& clients : *clients_container) {
-        clients.set_request_handler(message_response, std::bind_front(&this_type::on_clients_reponse_message, this));
-    }
-
     okec::print("{}\n", this->cache().dump(4));
 }
 
@@ -308,11 +286,13 @@ auto DQN_decision_engine::local_test(const task_element& header, client_device*
 
 auto DQN_decision_engine::send(task_element t, std::shared_ptr<client_device> client) -> bool
 {
-    static double launch_delay = 1.0;
+    // 客户端未指定到达过程时，沿用原来的发送间隔
+    if (!client->get_arrival_process())
+        client->set_arrival_process(std::make_shared<periodic_arrival>(0.1, 1.0));
 
     client->response_cache().emplace_back({
-        { "task_id", t.get_header("task_id") },
-        { "group", t.get_header("group") },
+        { "task_id", t.get_id().to_string() },
+        { "group", t.get_group() },
         { "finished", "0" }, // 1 indicates finished, while 0 signifies the opposite.
         { "device_type", "" },
         { "device_address", "" },
@@ -332,9 +312,8 @@ auto DQN_decision_engine::send(task_element t, std::shared_ptr<client_device> cl
     auto write = [client, bs, content = msg.to_packet()]() {
         client->write(content, bs->get_address(), bs->get_port());
     };
-    ns3::Simulator::Schedule(ns3::Seconds(launch_delay), write);
+    ns3::Simulator::Schedule(ns3::Seconds(client->next_launch_delay()), write);
     // ns3::Simulator::Schedule(ns3::Seconds(launch_delay), &client_device::write, client, msg.to_packet(), bs->get_address(), bs->get_port());
-    launch_delay += 0.1;
 
     return true;
 }
@@ -363,7 +342,7 @@ auto DQN_decision_engine::train(const task& train_task, int episode) -> void
     // auto observation = torch::tensor(state, torch::dtype(torch::kFloat64)).unsqueeze(0);
 
     // for (auto& t : train_task.elements()) {
-    //     t.set_header("status", "0"); // 0: 未处理 1: 已处理
+    //     t.set_status(0); // 0: 未处理 1: 已处理
     // }
 
     // train_next(std::move(observation));
@@ -423,35 +402,18 @@ auto DQN_decision_engine::train(const task& train_task, int episode) -> void
     // // });
 }
 
-auto DQN_decision_engine::initialize() -> void
-{
-    if (clients_) {
-        clients_->set_decision_engine(shared_from_base<this_type>());
-    }
-
-    if (clients_container_) {
-        for (auto& clients : *clients_container_) {
-            clients.set_decision_engine(shared_from_base<this_type>());
-        }
-    }
-
-    if (base_stations_) {
-        base_stations_->set_decision_engine(shared_from_base<this_type>());
-    }
-}
-
 auto DQN_decision_engine::handle_next() -> void
 {
     return void();
 }
 
 auto DQN_decision_engine::on_bs_decision_message(
-    base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+    base_station* bs, message& msg, const ns3::Address& remote_address) -> void
 {
     ns3::InetSocketAddress inetRemoteAddress = ns3::InetSocketAddress::ConvertFrom(remote_address);
     log::debug("The base station[{:ip}] has received the decision request from {:ip}.", bs->get_address(), inetRemoteAddress.GetIpv4());
 
-    auto item = okec::task_element::from_msg_packet(packet);
+    auto item = msg.get_task_element();
     bs->task_sequence(std::move(item));
 
     // bs->print_task_info();
@@ -459,22 +421,17 @@ auto DQN_decision_engine::on_bs_decision_message(
 }
 
 auto DQN_decision_engine::on_bs_response_message(
-    base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+    base_station* bs, message& msg, const ns3::Address& remote_address) -> void
 {
 }
 
 auto DQN_decision_engine::on_cs_handling_message(
-    cloud_server* cs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+    cloud_server* cs, message& msg, const ns3::Address& remote_address) -> void
 {
 }
 
 auto DQN_decision_engine::on_es_handling_message(
-    edge_device* es, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
-{
-}
-
-auto DQN_decision_engine::on_clients_reponse_message(
-    client_device* client, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+    edge_device* es, message& msg, const ns3::Address& remote_address) -> void
 {
 }
 
@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/analytical_simulator.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/log.h>
+#include <utility>
+
+
+namespace okec
+{
+
+namespace {
+
+constexpr uint16_t analytical_port = 8860;
+
+// 运行期间让 now:: 读取分析仿真的时钟
+struct clock_guard {
+    explicit clock_guard(const double* source)
+        : previous{ now::clock_source } {
+        now::clock_source = source;
+    }
+
+    ~clock_guard() {
+        now::clock_source = previous;
+    }
+
+    const double* previous;
+};
+
+} // namespace
+
+
+auto analytical_simulator::statistics::mean_response_time() const -> double
+{
+    return finished ? total_response_time / finished : 0.0;
+}
+
+auto analytical_simulator::statistics::mean_wait_time() const -> double
+{
+    return finished ? total_wait_time / finished : 0.0;
+}
+
+auto analytical_simulator::statistics::deadline_met_ratio() const -> double
+{
+    return with_deadline ? static_cast<double>(deadline_met) / with_deadline : 0.0;
+}
+
+auto analytical_simulator::statistics::to_json() const -> json
+{
+    return {
+        { "submitted", submitted },
+        { "finished", finished },
+        { "failed", failed },
+        { "with_deadline", with_deadline },
+        { "deadline_met", deadline_met },
+        { "events", events },
+        { "mean_response_time", mean_response_time() },
+        { "mean_wait_time", mean_wait_time() },
+        { "makespan", makespan }
+    };
+}
+
+analytical_simulator::analytical_simulator(std::shared_ptr<decision_engine> engine)
+    : engine_{ std::move(engine) }
+{
+    // 与 decision_engine::initialize_device 保持一致
+    auto& cache = engine_->cache();
+    cache.track("cpu");
+    cache.track("cpu", "es");
+}
+
+auto analytical_simulator::set_base_station(const ns3::Vector& position, const link& uplink) -> void
+{
+    engine_->set_decision_position(position);
+    uplink_ = uplink;
+}
+
+auto analytical_simulator::add_device(std::string_view device_type, double cpu,
+    const link& downlink, const ns3::Vector& position) -> index_type
+{
+    auto& cache = engine_->cache();
+    ns3::Ipv4Address ip(0x0A000000 + ++next_address_); // 10.0.0.0/8
+    auto index = cache.emplace(device_type, ip, analytical_port, position);
+    cache.set(index, "cpu", cpu);
+
+    if (downlinks_.size() <= index)
+        downlinks_.resize(index + 1);
+    downlinks_[index] = downlink;
+
+    return index;
+}
+
+auto analytical_simulator::add_edge_server(double cpu, const link& downlink, const ns3::Vector& position) -> index_type
+{
+    return add_device("es", cpu, downlink, position);
+}
+
+auto analytical_simulator::add_cloud(double cpu, const link& downlink, const ns3::Vector& position) -> index_type
+{
+    return add_device("cs", cpu, downlink, position);
+}
+
+auto analytical_simulator::submit(task t, double at) -> void
+{
+    auto batch = static_cast<std::uint32_t>(batches_.size());
+    records_.reserve(records_.size() + t.size());
+    for (std::size_t row = 0; row < t.size(); ++row) {
+        auto record = static_cast<std::uint32_t>(records_.size());
+        records_.push_back(task_record {
+            .batch = batch,
+            .row = static_cast<std::uint32_t>(row),
+            .submit_time = at,
+            .arrival_time = 0.0,
+            .dispatch_time = 0.0,
+            .start_time = 0.0,
+            .finish_time = 0.0
+        });
+        schedule(at + uplink_.delay(std::as_const(t).at(row).get_size()), event_type::arrival, record);
+    }
+
+    stats_.submitted += t.size();
+    batches_.push_back(std::move(t));
+}
+
+auto analytical_simulator::run(double until) -> statistics
+{
+    clock_guard guard(&now_);
+
+    while (!calendar_.empty() && calendar_.top().time <= until) {
+        auto ev = calendar_.top();
+        calendar_.pop();
+        now_ = ev.time;
+        ++stats_.events;
+
+        switch (ev.type) {
+        case event_type::arrival:
+            on_arrival(ev.record);
+            break;
+        case event_type::completion:
+            on_completion(ev.record);
+            break;
+        }
+    }
+
+    stats_.makespan = now_;
+    return stats_;
+}
+
+auto analytical_simulator::now() const -> double
+{
+    return now_;
+}
+
+auto analytical_simulator::records() const -> const std::vector<task_record>&
+{
+    return records_;
+}
+
+auto analytical_simulator::element(std::size_t record) -> task_element
+{
+    const auto& rec = records_[record];
+    return batches_[rec.batch].at(rec.row);
+}
+
+auto analytical_simulator::schedule(double time, event_type type, std::uint32_t record) -> void
+{
+    calendar_.push(event{ time, sequence_++, type, record });
+}
+
+auto analytical_simulator::on_arrival(std::uint32_t record) -> void
+{
+    auto& rec = records_[record];
+    rec.arrival_time = now_;
+
+    // 与基站收到任务时写入的头部保持一致
+    auto item = element(record);
+    item.set_header("arrival_time", okec::format("{:.9f}", now_));
+    item.set_header("transmission_delay", okec::format("{:.9f}", now_ - rec.submit_time));
+
+    waiting_.push_back(record);
+    dispatch();
+}
+
+auto analytical_simulator::on_completion(std::uint32_t record) -> void
+{
+    auto& rec = records_[record];
+    auto& cache = engine_->cache();
+    auto item = element(record);
+
+    if (cache.device_type(rec.device) != "cs")
+        cache.set(rec.device, "cpu", cache.get(rec.device, "cpu") + item.get_cpu());
+    --running_;
+
+    // 响应结果很小，只计传播时延
+    rec.finish_time = now_ + downlinks_[rec.device].propagation_delay + uplink_.propagation_delay;
+    rec.state = task_state::finished;
+
+    double response_time = rec.finish_time - rec.submit_time;
+    ++stats_.finished;
+    stats_.total_response_time += response_time;
+    stats_.total_wait_time += rec.dispatch_time - rec.arrival_time;
+    if (auto deadline = item.get_deadline(); deadline > 0) {
+        ++stats_.with_deadline;
+        if (response_time <= deadline)
+            ++stats_.deadline_met;
+    }
+
+    dispatch();
+}
+
+auto analytical_simulator::dispatch() -> void
+{
+    auto& cache = engine_->cache();
+
+    while (!waiting_.empty()) {
+        auto record = waiting_.front();
+        auto item = element(record);
+        auto device = engine_->decide(item);
+        bool consumes = device != device_cache::npos && cache.device_type(device) != "cs";
+        double cpu_demand = item.get_cpu();
+        double cpu_supply = device != device_cache::npos ? cache.get(device, "cpu") : 0.0;
+
+        if (!(cpu_supply > 0) || (consumes && cpu_supply < cpu_demand)) {
+            // 等待运行中的任务释放资源
+            if (running_ > 0)
+                return;
+
+            log::error("No device can handle the task({})!", item.get_id());
+            records_[record].state = task_state::failed;
+            ++stats_.failed;
+            waiting_.pop_front();
+            continue;
+        }
+
+        waiting_.pop_front();
+
+        double transmission_delay = downlinks_[device].delay(item.get_size());
+        double processing_time = cpu_demand / cpu_supply;
+
+        auto& rec = records_[record];
+        rec.device = device;
+        rec.dispatch_time = now_;
+        rec.start_time = now_ + transmission_delay;
+        rec.state = task_state::running;
+        if (consumes)
+            cache.set(device, "cpu", cpu_supply - cpu_demand);
+        ++running_;
+
+        schedule(rec.start_time + processing_time, event_type::completion, record);
+    }
+}
+
+} // namespace okec
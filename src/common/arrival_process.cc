@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/arrival_process.h>
+#include <okec/utils/log.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+
+
+namespace okec
+{
+
+namespace {
+
+// 指数分布的间隔，u 取自 (0, 1]
+auto exponential_gap(ns3::UniformRandomVariable& uniform, double rate) -> double
+{
+    return -std::log(1.0 - uniform.GetValue()) / rate;
+}
+
+} // namespace
+
+
+poisson_arrival::poisson_arrival(double rate)
+    : rate_{ rate },
+      uniform_{ ns3::CreateObject<ns3::UniformRandomVariable>() }
+{
+}
+
+auto poisson_arrival::next() -> std::optional<double>
+{
+    return exponential_gap(*uniform_, rate_);
+}
+
+mmpp_arrival::mmpp_arrival(std::vector<double> rates, std::vector<std::vector<double>> transitions,
+    std::size_t initial_state)
+    : rates_{ std::move(rates) },
+      transitions_{ std::move(transitions) },
+      state_{ initial_state },
+      uniform_{ ns3::CreateObject<ns3::UniformRandomVariable>() }
+{
+    transitions_.resize(rates_.size());
+    for (std::size_t i = 0; i < rates_.size(); ++i) {
+        transitions_[i].resize(rates_.size());
+        transitions_[i][i] = 0.0;
+        leave_rates_.push_back(std::accumulate(transitions_[i].begin(), transitions_[i].end(), 0.0));
+    }
+}
+
+auto mmpp_arrival::next() -> std::optional<double>
+{
+    double elapsed = 0.0;
+    for (;;) {
+        // 到达与状态切换相互竞争，先发生者生效
+        double arrival = exponential(rates_[state_]);
+        double leave = exponential(leave_rates_[state_]);
+        if (arrival <= leave)
+            return elapsed + arrival;
+
+        elapsed += leave;
+        double pick = uniform_->GetValue() * leave_rates_[state_];
+        const auto& row = transitions_[state_];
+        for (std::size_t j = 0; j < row.size(); ++j) {
+            if (row[j] <= 0.0)
+                continue;
+            state_ = j;
+            if ((pick -= row[j]) < 0.0)
+                break;
+        }
+    }
+}
+
+auto mmpp_arrival::state() const -> std::size_t
+{
+    return state_;
+}
+
+auto mmpp_arrival::exponential(double rate) -> double
+{
+    return rate > 0.0 ? exponential_gap(*uniform_, rate) : std::numeric_limits<double>::infinity();
+}
+
+periodic_arrival::periodic_arrival(double period, double offset)
+    : period_{ period },
+      offset_{ offset }
+{
+}
+
+auto periodic_arrival::next() -> std::optional<double>
+{
+    if (!started_) {
+        started_ = true;
+        return offset_;
+    }
+
+    return period_;
+}
+
+trace_arrival::trace_arrival(std::vector<double> timestamps)
+    : timestamps_{ std::move(timestamps) }
+{
+}
+
+trace_arrival::trace_arrival(csv_reader reader, std::size_t column)
+    : reader_{ std::make_unique<csv_reader>(std::move(reader)) },
+      row_{ reader_->begin() },
+      column_{ column }
+{
+}
+
+auto trace_arrival::load(std::string_view file, std::size_t column) -> trace_arrival
+{
+    csv_reader reader(file, ',', false);
+    if (!reader.is_open())
+        log::error("Failed to open the arrival trace {}", file);
+
+    return trace_arrival{ std::move(reader), column };
+}
+
+auto trace_arrival::next_timestamp() -> std::optional<double>
+{
+    if (!reader_) {
+        if (pos_ >= timestamps_.size())
+            return std::nullopt;
+        return timestamps_[pos_++];
+    }
+
+    for (; row_ != std::default_sentinel; ++row_) {
+        ++rows_;
+        auto field = (*row_)[column_];
+        while (!field.empty() && field.front() == ' ')
+            field.remove_prefix(1);
+        while (!field.empty() && (field.back() == ' ' || field.back() == '\r'))
+            field.remove_suffix(1);
+
+        // 整个字段都必须是数字，"12abc" 不算
+        double value{};
+        auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+        if (!field.empty() && ec == std::errc{} && ptr == field.data() + field.size()) {
+            ++row_;
+            return value;
+        }
+
+        if (rows_ > 1) {
+            ++skipped_;
+            log::warning("arrival trace: skipping line {}: {}", rows_, row_->line());
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto trace_arrival::next() -> std::optional<double>
+{
+    auto timestamp = this->next_timestamp();
+    if (!timestamp)
+        return std::nullopt;
+
+    double gap = std::max(0.0, *timestamp - last_);
+    last_ = *timestamp;
+    return gap;
+}
+
+} // namespace okec
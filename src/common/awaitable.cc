@@ -10,21 +10,100 @@
 
 #include <okec/common/awaitable.h>
 #include <okec/common/simulator.h>
+#include <okec/devices/client_device.h>
 #include <okec/utils/log.h>
+#include <array>
 #include <utility> // exchange
 #include <stdexcept>
 
 
 namespace okec {
 
+namespace {
+
+constexpr std::size_t frame_granularity = 64;
+constexpr std::size_t frame_classes     = 16; // 64 B .. 1 KiB
+constexpr std::size_t frame_chunk_size  = 64 * 1024;
+
+struct free_frame {
+    free_frame* next;
+};
+
+thread_local std::array<free_frame*, frame_classes> free_frames{};
+
+// 转到 next 继续执行，当前协程停在这里直到被销毁
+struct transfer_to {
+    std::coroutine_handle<> next;
+
+    auto await_ready() const noexcept -> bool { return false; }
+    auto await_suspend(std::coroutine_handle<>) const noexcept -> std::coroutine_handle<> {
+        return next ? next : std::noop_coroutine();
+    }
+    auto await_resume() const noexcept -> void {}
+};
+
+// 等待 coro 结束，然后转到 on_done() 返回的协程
+template <class F>
+auto watch(awaitable coro, F on_done) -> awaitable
+{
+    co_await std::move(coro);
+    co_await transfer_to{ on_done() };
+}
+
+auto frame_class(std::size_t size) noexcept -> std::size_t
+{
+    return (size + frame_granularity - 1) / frame_granularity - 1;
+}
+
+// 切分一个新的 chunk 补充该尺寸类的空闲链表
+auto refill(std::size_t cls) -> void
+{
+    std::size_t block_size = (cls + 1) * frame_granularity;
+    auto chunk = static_cast<std::byte*>(::operator new(frame_chunk_size));
+    for (std::size_t offset = 0; offset + block_size <= frame_chunk_size; offset += block_size) {
+        auto block = reinterpret_cast<free_frame*>(chunk + offset);
+        block->next = free_frames[cls];
+        free_frames[cls] = block;
+    }
+}
+
+} // namespace
+
+auto frame_pool::allocate(std::size_t size) -> void*
+{
+    auto cls = frame_class(size);
+    if (cls >= frame_classes)
+        return ::operator new(size);
+
+    if (!free_frames[cls])
+        refill(cls);
+
+    auto block = free_frames[cls];
+    free_frames[cls] = block->next;
+    return block;
+}
+
+auto frame_pool::deallocate(void* ptr, std::size_t size) noexcept -> void
+{
+    auto cls = frame_class(size);
+    if (cls >= frame_classes) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    auto block = static_cast<free_frame*>(ptr);
+    block->next = free_frames[cls];
+    free_frames[cls] = block;
+}
+
 auto awaitable_promise_base::initial_suspend() noexcept -> std::suspend_never
 {
     return {};
 }
 
-auto awaitable_promise_base::final_suspend() noexcept -> std::suspend_always
+auto awaitable_promise_base::final_suspend() noexcept -> final_awaiter
 {
-    return {};
+    return final_awaiter{ continuation_ };
 }
 
 auto awaitable_promise_base::unhandled_exception() -> void
@@ -70,6 +149,11 @@ void awaitable::resume()
         handle_.resume();
 }
 
+auto awaitable::done() const noexcept -> bool
+{
+    return !handle_ || handle_.done();
+}
+
 // void awaitable::start()
 // {
 //     resume();
@@ -80,31 +164,166 @@ awaitable::awaitable(std::coroutine_handle<promise_type> handle) noexcept
 {
 }
 
-response_awaiter::response_awaiter(simulator& sim, std::string client_address)
-    : sim{ sim },
-      client_address{ client_address }
+response_awaiter::response_awaiter(client_device& client, completion_token token)
+    : client{ client },
+      token{ token }
 {
 }
 
+response_awaiter::~response_awaiter()
+{
+    // 协程在等待期间被放弃（如 when_any、with_timeout）
+    if (suspended)
+        client.cancel_completion(&r);
+}
+
 auto response_awaiter::await_ready() noexcept -> bool
 {
-    // log::debug("response_awaiter::await_ready()");
-    return false;
+    // 响应可能在等待之前就已经完成
+    return client.take_completed(token, r);
 }
 
 auto response_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept -> void
 {
-    // log::debug("response_awaiter::await_suspend()");
-    sim.submit(client_address, [this, handle](response&& resp) {
-        this->r = std::move(resp);
+    client.await_completion(token, handle, &r);
+    suspended = true;
+}
+
+auto response_awaiter::await_resume() noexcept -> response
+{
+    suspended = false;
+    return std::move(this->r);
+}
+
+send_awaiter::send_awaiter(completion_token token) noexcept
+    : token{ token }
+{
+}
+
+auto send_awaiter::await_ready() const noexcept -> bool
+{
+    return true;
+}
+
+auto send_awaiter::await_suspend(std::coroutine_handle<>) const noexcept -> void
+{
+}
+
+auto send_awaiter::await_resume() const noexcept -> completion_token
+{
+    return token;
+}
+
+sleep_for::sleep_for(ns3::Time delay)
+    : delay_{ delay }
+{
+}
+
+sleep_for::~sleep_for()
+{
+    event_.Cancel();
+}
+
+auto sleep_for::await_ready() const noexcept -> bool
+{
+    return false;
+}
+
+auto sleep_for::await_suspend(std::coroutine_handle<> handle) -> void
+{
+    event_ = ns3::Simulator::Schedule(delay_, [handle] {
         handle.resume();
     });
 }
 
-auto response_awaiter::await_resume() noexcept -> response
+auto when_all(std::vector<awaitable> coros) -> awaitable
+{
+    for (auto& coro : coros)
+        co_await std::move(coro);
+}
+
+when_any::when_any(std::vector<awaitable> coros)
+    : coros_{ std::move(coros) }
+{
+}
+
+auto when_any::await_ready() noexcept -> bool
+{
+    for (std::size_t i = 0; i < coros_.size(); ++i) {
+        if (coros_[i].done()) {
+            index_ = i;
+            return true;
+        }
+    }
+
+    return coros_.empty();
+}
+
+auto when_any::await_suspend(std::coroutine_handle<> handle) -> void
 {
-    // log::debug("response_awaiter::await_resume()");
-    return this->r;
+    waiter_ = handle;
+    watchers_.reserve(coros_.size());
+    for (std::size_t i = 0; i < coros_.size(); ++i) {
+        watchers_.push_back(watch(std::move(coros_[i]), [this, i]() -> std::coroutine_handle<> {
+            // 只有第一个结束的协程唤醒等待者
+            if (index_ != npos)
+                return nullptr;
+            index_ = i;
+            return waiter_;
+        }));
+    }
+}
+
+auto when_any::await_resume() const noexcept -> std::size_t
+{
+    return index_;
+}
+
+with_timeout::with_timeout(awaitable coro, ns3::Time timeout)
+    : coro_{ std::move(coro) },
+      timeout_{ timeout }
+{
+}
+
+with_timeout::~with_timeout()
+{
+    timer_.Cancel();
+}
+
+auto with_timeout::await_ready() noexcept -> bool
+{
+    completed_ = coro_.done();
+    return completed_;
+}
+
+auto with_timeout::await_suspend(std::coroutine_handle<> handle) -> void
+{
+    waiter_ = handle;
+    watcher_ = watch(std::move(coro_), [this]() -> std::coroutine_handle<> {
+        if (finished_)
+            return nullptr;
+        finished_ = completed_ = true;
+        timer_.Cancel();
+        return waiter_;
+    });
+    timer_ = ns3::Simulator::Schedule(timeout_, [this] {
+        expire();
+    });
+}
+
+auto with_timeout::await_resume() const noexcept -> bool
+{
+    return completed_;
+}
+
+auto with_timeout::expire() -> void
+{
+    if (finished_)
+        return;
+
+    // 唤醒等待者，协程随 with_timeout 一起销毁
+    finished_ = true;
+    waiter_.resume();
 }
 
 auto co_spawn(okec::simulator &ctx, okec::awaitable a) -> void
@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/experiment_runner.h>
+#include <okec/common/task_id.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/log.h>
+#include <ns3/core-module.h>
+#include <torch/torch.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+namespace okec
+{
+
+namespace {
+
+auto splitmix64(std::uint64_t x) -> std::uint64_t
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+auto write_all(int fd, const char* data, std::size_t size) -> bool
+{
+    while (size > 0) {
+        auto n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// 子进程：设定种子，运行场景，把结果写回父进程
+[[noreturn]] auto run_worker(const experiment_runner::scenario_type& scenario,
+    const experiment_runner::run_info& info, int fd) -> void
+{
+    ns3::RngSeedManager::SetRun(info.seed);
+    torch::manual_seed(info.seed);
+    task_id::seed(info.seed);
+
+    int status = 0;
+    std::string out;
+    try {
+        out = scenario(info).dump();
+    } catch (const std::exception& e) {
+        out = json{ { "error", e.what() } }.dump();
+        status = 1;
+    }
+
+    if (!write_all(fd, out.data(), out.size()))
+        status = 2;
+    ::close(fd);
+
+    // 跳过静态析构，ns3 的全局状态属于父进程
+    ::_exit(status);
+}
+
+struct worker {
+    pid_t pid;
+    int fd;
+    std::size_t index;
+    std::string output;
+};
+
+auto finish(worker& w) -> json
+{
+    ::close(w.fd);
+
+    int status = 0;
+    while (::waitpid(w.pid, &status, 0) < 0 && errno == EINTR) {}
+
+    auto result = json::parse(w.output, nullptr, false);
+    if (result.is_discarded()) {
+        if (WIFSIGNALED(status))
+            return json{ { "error", okec::format("worker killed by signal {}", WTERMSIG(status)) } };
+        return json{ { "error", okec::format("worker exited with status {}", WEXITSTATUS(status)) } };
+    }
+
+    return result;
+}
+
+} // namespace
+
+
+auto parameter_grid::add(std::string name, std::vector<json> values) -> parameter_grid&
+{
+    params_.emplace_back(std::move(name), std::move(values));
+    return *this;
+}
+
+auto parameter_grid::size() const -> std::size_t
+{
+    if (params_.empty())
+        return 0;
+
+    std::size_t n = 1;
+    for (const auto& [_, values] : params_)
+        n *= values.size();
+    return n;
+}
+
+auto parameter_grid::at(std::size_t index) const -> json
+{
+    json point = json::object();
+    for (auto it = params_.rbegin(); it != params_.rend(); ++it) {
+        const auto& [name, values] = *it;
+        point[name] = values[index % values.size()];
+        index /= values.size();
+    }
+    return point;
+}
+
+experiment_runner::experiment_runner(scenario_type scenario)
+    : scenario_{ std::move(scenario) }
+    , workers_{ std::max(1u, std::thread::hardware_concurrency()) }
+{
+}
+
+auto experiment_runner::workers(std::size_t n) -> experiment_runner&
+{
+    workers_ = std::max<std::size_t>(1, n);
+    return *this;
+}
+
+auto experiment_runner::seed(std::uint64_t base) -> experiment_runner&
+{
+    seed_ = base;
+    return *this;
+}
+
+auto experiment_runner::on_result(result_callback_type fn) -> experiment_runner&
+{
+    on_result_ = std::move(fn);
+    return *this;
+}
+
+auto experiment_runner::seed_of(std::size_t index) const -> std::uint64_t
+{
+    // ns-3 run numbers start at 1
+    return splitmix64(seed_ ^ splitmix64(index)) | 1;
+}
+
+auto experiment_runner::run(const parameter_grid& grid) -> std::vector<json>
+{
+    const auto total = grid.size();
+    std::vector<json> results(total);
+    std::vector<worker> running;
+    std::size_t next = 0;
+
+    auto info_of = [&](std::size_t index) {
+        return run_info{ index, grid.at(index), seed_of(index) };
+    };
+
+    auto report = [&](std::size_t index, json result) {
+        if (on_result_)
+            on_result_(info_of(index), result);
+        results[index] = std::move(result);
+    };
+
+    while (next < total || !running.empty()) {
+        // 补足并行的工作进程
+        while (next < total && running.size() < workers_) {
+            auto info = info_of(next);
+
+            int fds[2];
+            if (::pipe(fds) < 0) {
+                report(next++, json{ { "error", okec::format("pipe: {}", std::strerror(errno)) } });
+                continue;
+            }
+
+            auto pid = ::fork();
+            if (pid == 0) {
+                ::close(fds[0]);
+                for (const auto& w : running)
+                    ::close(w.fd);
+                run_worker(scenario_, info, fds[1]);
+            }
+
+            ::close(fds[1]);
+            if (pid < 0) {
+                ::close(fds[0]);
+                report(next++, json{ { "error", okec::format("fork: {}", std::strerror(errno)) } });
+                continue;
+            }
+
+            log::debug("experiment point {} started in process {}: {}", next, pid, info.params.dump());
+            running.push_back({ pid, fds[0], next++, {} });
+        }
+
+        if (running.empty())
+            break;
+
+        std::vector<pollfd> fds;
+        fds.reserve(running.size());
+        for (const auto& w : running)
+            fds.push_back({ w.fd, POLLIN, 0 });
+
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(okec::format("experiment_runner: poll: {}", std::strerror(errno)));
+        }
+
+        char buf[64 * 1024];
+        for (std::size_t i = fds.size(); i-- > 0;) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+
+            auto& w = running[i];
+            auto n = ::read(w.fd, buf, sizeof(buf));
+            if (n > 0) {
+                w.output.append(buf, static_cast<std::size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+
+            // EOF：进程已写完结果
+            auto index = w.index;
+            auto result = finish(w);
+            running.erase(running.begin() + i);
+            report(index, std::move(result));
+        }
+    }
+
+    return results;
+}
+
+
+} // namespace okec
@@ -14,6 +14,7 @@ namespace okec
 {
 
 message::message(ns3::Ptr<ns3::Packet> packet)
+    : wire_size_{ packet ? packet->GetSize() : 0 }
 {
     auto j = packet_helper::to_json(packet);
     if (!j.is_null())
@@ -29,6 +30,7 @@ message::message(std::initializer_list<std::pair<std::string_view, std::string_v
 
 message::message(const message& other)
     : j_ { other.j_ }
+    , wire_size_ { other.wire_size_ }
 {
 }
 
@@ -79,9 +81,14 @@ auto message::type() -> std::string
 //     return r;
 // }
 
+auto message::wire_size() const noexcept -> std::uint32_t
+{
+    return wire_size_;
+}
+
 auto message::to_packet() -> ns3::Ptr<ns3::Packet>
 {
-    return packet_helper::make_packet(this->dump());
+    return packet_helper::to_packet(j_);
 }
 
 auto message::from_packet(ns3::Ptr<ns3::Packet> packet) -> message
@@ -111,6 +118,14 @@ auto message::get_task_element() -> task_element
     return task_element{nullptr};
 }
 
+auto message::get_resource() -> resource
+{
+    if (!j_.is_null() && j_.contains("/content/resource"_json_pointer))
+        return resource(j_["content"]);
+
+    return resource{};
+}
+
 auto message::valid() -> bool
 {
     if (j_.contains("msgtype") && j_.contains("content"))
@@ -123,6 +138,7 @@ void swap(message& lhs, message& rhs) noexcept
 {
     using std::swap;
     swap(lhs.j_, rhs.j_);
+    swap(lhs.wire_size_, rhs.wire_size_);
 }
 
 } // namespace okec
\ No newline at end of file
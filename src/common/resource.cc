@@ -10,7 +10,10 @@
 
 #include <okec/common/resource.h>
 #include <okec/utils/format_helper.hpp>
+#include <charconv>
+#include <cmath>
 #include <fstream>
+#include <limits>
 #include <random>
 
 
@@ -24,6 +27,54 @@ namespace okec
 NS_OBJECT_ENSURE_REGISTERED(resource);
 
 
+namespace {
+
+auto format_number(double value) -> std::string
+{
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    return std::string(buf, end);
+}
+
+auto parse_number(std::string_view sv, double& value) -> bool
+{
+    if (sv.empty())
+        return false;
+    auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), value);
+    return ec == std::errc{} && ptr == sv.data() + sv.size();
+}
+
+constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+} // namespace
+
+
+// 同一时刻的变化攒在一起，时间推进后统一回调
+struct resource::change_batch : std::enable_shared_from_this<change_batch> {
+    batch_monitor_type monitor;
+    std::vector<change> changes;
+    bool scheduled = false;
+
+    auto push(change c) -> void {
+        changes.push_back(std::move(c));
+        if (!std::exchange(scheduled, true)) {
+            // one time step later every event of the current time has run
+            ns3::Simulator::Schedule(ns3::TimeStep(1), [self = shared_from_this()] {
+                self->flush();
+            });
+        }
+    }
+
+    auto flush() -> void {
+        scheduled = false;
+        auto pending = std::exchange(changes, {});
+        if (monitor && !pending.empty())
+            monitor(pending);
+    }
+};
+
+
+
 auto resource::GetTypeId() -> ns3::TypeId
 {
     static ns3::TypeId tid = ns3::TypeId("okec::resource")
@@ -48,15 +99,26 @@ resource::resource(json item) noexcept
 auto resource::attribute(std::string_view key, std::string_view value) -> void
 {
     j_["resource"][key] = value;
+    if (auto it = numbers_.find(key); it != numbers_.end())
+        numbers_.erase(it);
+    ++version_;
+    history_.clear();
+    history_floor_ = version_;
 }
 
 auto resource::reset_value(std::string_view key, std::string_view value) -> std::string
 {
-    auto old_value = std::exchange(j_["resource"][key], value);
-    if (monitor_) {
-        monitor_(okec::format("{:ip}", get_address()), key, old_value.get<std::string>(), value);
-    }
-    
+    auto old_value = this->get_value(key);
+    auto old_number = this->get_number(key);
+
+    double new_number = nan;
+    if (parse_number(value, new_number))
+        numbers_.insert_or_assign(std::string(key), number_slot{ new_number, false });
+    else if (auto it = numbers_.find(key); it != numbers_.end())
+        numbers_.erase(it);
+    j_["resource"][key] = value;
+
+    this->notify(key, old_number, new_number, old_value, value);
     return old_value;
 }
 
@@ -65,8 +127,115 @@ auto resource::set_monitor(monitor_type monitor) -> void
     monitor_ = monitor;
 }
 
+auto resource::set_batch_monitor(batch_monitor_type monitor) -> void
+{
+    batch_ = std::make_shared<change_batch>();
+    batch_->monitor = std::move(monitor);
+}
+
+auto resource::get_number(std::string_view key) const -> double
+{
+    if (auto it = numbers_.find(key); it != numbers_.end())
+        return it->second.value;
+
+    double value = nan;
+    if (auto text = this->get_value(key); parse_number(text, value))
+        numbers_.emplace(std::string(key), number_slot{ value, false });
+    return value;
+}
+
+auto resource::set_number(std::string_view key, double value) -> double
+{
+    auto old_number = this->get_number(key);
+
+    auto it = numbers_.find(key);
+    if (it == numbers_.end()) {
+        // 新属性直接写入，保证 empty()/begin() 能看到它
+        it = numbers_.emplace(std::string(key), number_slot{ value, false }).first;
+        j_["resource"][key] = format_number(value);
+    } else {
+        it->second = { value, true };
+    }
+
+    if (monitor_)
+        this->notify(key, old_number, value, format_number(old_number), format_number(value));
+    else
+        this->notify(key, old_number, value, {}, {});
+
+    return old_number;
+}
+
+auto resource::add(std::string_view key, double delta) -> double
+{
+    auto value = this->get_number(key) + delta;
+    this->set_number(key, value);
+    return value;
+}
+
+auto resource::subtract(std::string_view key, double delta) -> double
+{
+    return this->add(key, -delta);
+}
+
+auto resource::sync() const -> void
+{
+    for (auto& [key, slot] : numbers_) {
+        if (slot.dirty) {
+            j_["resource"][key] = format_number(slot.value);
+            slot.dirty = false;
+        }
+    }
+}
+
+auto resource::notify(std::string_view key, double old_number, double new_number,
+    std::string_view old_value, std::string_view new_value) -> void
+{
+    ++version_;
+    history_.push_back({ version_, std::string(key), new_number - old_number });
+    if (history_.size() > history_limit) {
+        history_floor_ = history_.front().version;
+        history_.pop_front();
+    }
+
+    if (monitor_) {
+        if (address_.empty())
+            address_ = okec::format("{:ip}", get_address());
+        monitor_(address_, key, old_value, new_value);
+    }
+
+    if (batch_)
+        batch_->push({ this, std::string(key), old_number, new_number });
+}
+
+auto resource::version() const -> std::uint64_t
+{
+    return version_;
+}
+
+auto resource::drift_since(std::uint64_t version, std::string_view key) const -> std::optional<drift>
+{
+    if (version < history_floor_)
+        return std::nullopt;
+
+    drift result;
+    for (auto it = history_.rbegin(); it != history_.rend() && it->version > version; ++it) {
+        if (it->key != key)
+            continue;
+        if (std::isnan(it->delta))
+            return std::nullopt;
+        if (it->delta < 0)
+            result.consumed -= it->delta;
+        else
+            result.released += it->delta;
+    }
+    return result;
+}
+
 auto resource::get_value(std::string_view key) const -> std::string
 {
+    if (auto it = numbers_.find(key); it != numbers_.end() && it->second.dirty)
+        return format_number(it->second.value);
+
     std::string result{};
     json::json_pointer j_key{ "/resource/" + std::string(key) };
     if (j_.contains(j_key))
@@ -81,8 +250,17 @@ auto resource::get_address() -> ns3::Ipv4Address
     return ipv4->GetAddress(1, 0).GetLocal();
 }
 
+auto resource::keys() const -> std::vector<std::string>
+{
+    std::vector<std::string> result;
+    for (auto it = this->begin(); it != this->end(); ++it)
+        result.push_back(it.key());
+    return result;
+}
+
 auto resource::dump(const int indent) -> std::string
 {
+    this->sync();
     return j_.dump(indent);
 }
 
@@ -93,6 +271,7 @@ auto resource::empty() const -> bool
 
 auto resource::j_data() const -> json
 {
+    this->sync();
     return j_;
 }
 
@@ -100,6 +279,10 @@ auto resource::set_data(json item) -> bool
 {
     if (item.contains("/resource"_json_pointer)) {
         j_ = std::move(item);
+        numbers_.clear();
+        ++version_;
+        history_.clear();
+        history_floor_ = version_;
         return true;
     }
 
@@ -251,4 +434,14 @@ auto resource_container::set_monitor(resource::monitor_type monitor) -> void
     }
 }
 
+auto resource_container::set_batch_monitor(resource::batch_monitor_type monitor) -> void
+{
+    // 所有资源共用一个批次
+    auto batch = std::make_shared<resource::change_batch>();
+    batch->monitor = std::move(monitor);
+    for (const auto& item : m_resources) {
+        item->batch_ = batch;
+    }
+}
+
 } // namespace okec
\ No newline at end of file
@@ -147,4 +147,110 @@ auto response::emplace_back(json item) -> void
     j_["response"]["items"].emplace_back(std::move(item));
 }
 
+auto response_tracker::emplace_back(attributes_type values) -> bool
+{
+    value_type item;
+    for (auto [key, value] : values) {
+        item[key] = value;
+    }
+
+    auto id = task_id::of(item["task_id"].get_ref<const std::string&>());
+    const auto& group_name = item["group"].get_ref<const std::string&>();
+
+    // 重复注册的任务原地替换，计数只随 finished 的变化调整
+    if (auto it = index_.find(id); it != index_.end()) {
+        auto& [group, pos] = it->second;
+        auto& old = group->items[pos];
+        if (old["group"] != group_name) {
+            log::error("task({}) is already registered in group {}", id, old["group"].get_ref<const std::string&>());
+            return false;
+        }
+
+        bool was_pending = old["finished"] == "0";
+        bool pending = item["finished"] == "0";
+        if (was_pending && !pending)
+            --group->outstanding;
+        else if (!was_pending && pending)
+            ++group->outstanding;
+        old = std::move(item);
+        return true;
+    }
+
+    auto [it, inserted] = groups_.try_emplace(group_name);
+    auto& group = it->second;
+    if (inserted)
+        group.token = ++next_token_;
+
+    if (item["finished"] == "0")
+        ++group.outstanding;
+    index_.emplace(id, entry{ &group, group.items.size() });
+    group.items.push_back(std::move(item));
+    return true;
+}
+
+auto response_tracker::find(const task_id& id) -> value_type*
+{
+    auto it = index_.find(id);
+    return it == index_.end() ? nullptr : &it->second.group->items[it->second.pos];
+}
+
+auto response_tracker::finish(const task_id& id, std::string_view state) -> bool
+{
+    auto it = index_.find(id);
+    if (it == index_.end())
+        return false;
+
+    auto& [group, pos] = it->second;
+    auto& finished = group->items[pos]["finished"];
+    if (finished == "0" && state != "0")
+        --group->outstanding;
+    else if (finished != "0" && state == "0")
+        ++group->outstanding;
+    finished = state;
+    return true;
+}
+
+auto response_tracker::contains(std::string_view group) const -> bool
+{
+    return groups_.find(group) != groups_.end();
+}
+
+auto response_tracker::outstanding(std::string_view group) const -> std::size_t
+{
+    auto it = groups_.find(group);
+    return it == groups_.end() ? 0 : it->second.outstanding;
+}
+
+auto response_tracker::token(std::string_view group) const -> completion_token
+{
+    auto it = groups_.find(group);
+    return it == groups_.end() ? 0 : it->second.token;
+}
+
+auto response_tracker::take(std::string_view group) -> response
+{
+    response result;
+    auto it = groups_.find(group);
+    if (it == groups_.end())
+        return result;
+
+    for (auto& item : it->second.items) {
+        index_.erase(task_id::of(item["task_id"].get_ref<const std::string&>()));
+        result.emplace_back(std::move(item));
+    }
+    groups_.erase(it);
+
+    return result;
+}
+
+auto response_tracker::size() const -> std::size_t
+{
+    return index_.size();
+}
+
+auto response_tracker::empty() const -> bool
+{
+    return index_.empty();
+}
+
 } // namespace okec
\ No newline at end of file
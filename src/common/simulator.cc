@@ -1,7 +1,7 @@
 #include <okec/common/simulator.h>
-#include <okec/common/response.h>
 #include <okec/config/config.h>
 #include <okec/utils/log.h>
+#include <okec/utils/packet_helper.h>
 
 
 
@@ -41,35 +41,29 @@ auto simulator::enable_visualizer() -> void
     ns3::GlobalValue::Bind("SimulatorImplementationType", ns3::StringValue("ns3::VisualSimulatorImpl"));
 }
 
-auto simulator::submit(const std::string &ip, std::function<void(response &&)> fn) -> void
+auto simulator::wire_format(wire::format fmt) -> void
 {
-    completion_[ip] = fn;
+    packet_helper::set_wire_format(fmt);
 }
 
-auto simulator::complete(const std::string& ip, response&& r) -> void
+auto simulator::wire_format() const -> wire::format
 {
-    if (auto it = completion_.find(ip);
-        it != completion_.end()) {
-        auto fn = it->second;
-        completion_.erase(it);
-        fn(std::move(r));
-    }
+    return packet_helper::get_wire_format();
 }
 
-auto simulator::is_valid(const std::string &ip) -> bool
+auto simulator::hold_coro(awaitable a) -> void
 {
-    if (auto it = completion_.find(ip);
-        it != completion_.end()) {
-        return true;
+    // 已经执行完毕的协程无需保留
+    if (a.done())
+        return;
+
+    // 均摊 O(1)：协程数翻倍时清扫一次已结束的协程
+    if (coros_.size() >= reap_threshold_) {
+        std::erase_if(coros_, [](const awaitable& coro) { return coro.done(); });
+        reap_threshold_ = std::max<std::size_t>(64, coros_.size() * 2);
     }
 
-    return false;
-}
-
-auto simulator::hold_coro(awaitable a) -> void
-{
     coros_.emplace_back(std::move(a));
-    // coros_[coros_.size() - 1].start();
 }
 
 
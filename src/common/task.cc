@@ -11,9 +11,10 @@
 #include <okec/common/task.h>
 #include <okec/utils/format_helper.hpp>
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <fstream>
-#include <random>
-#include <sstream>
+#include <iomanip>
 #include <ns3/ptr.h>
 
 
@@ -21,78 +22,515 @@
 namespace okec
 {
 
-task_element::task_element(json* item) noexcept
+namespace {
+
+auto format_number(double value) -> std::string
 {
-    if (item->contains("/header"_json_pointer)) {
-        elem_ = item; // ref
-        is_dynamically_allocated = false;
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    return std::string(buf, end);
+}
+
+template <typename T>
+auto parse_number(std::string_view sv, T& value) -> bool
+{
+    auto last = sv.data() + sv.size();
+    auto [ptr, ec] = std::from_chars(sv.data(), last, value);
+    return !sv.empty() && ec == std::errc{} && ptr == last;
+}
+
+auto to_attribute_value(const json& value) -> std::string
+{
+    return value.is_string() ? value.get<std::string>() : value.dump();
+}
+
+} // namespace
+
+
+//////////////////////////////////////////////////////////////////////////////
+// task_table
+//////////////////////////////////////////////////////////////////////////////
+
+auto task_table::attribute_column::contains(size_type row) const -> bool
+{
+    return row < present.size() && present[row];
+}
+
+auto task_table::attribute_column::set(size_type row, std::string_view value) -> void
+{
+    if (row >= values.size()) {
+        values.resize(row + 1);
+        present.resize(row + 1);
     }
-    else
-        elem_ = nullptr;
+
+    values[row] = value;
+    present[row] = true;
 }
 
-task_element::task_element(json item) noexcept
+auto task_table::attribute_column::erase(size_type row) -> void
 {
-    if (item.contains("/header"_json_pointer)) {
-        elem_ = new json(std::move(item)); // copy
-        is_dynamically_allocated = true;
+    if (contains(row)) {
+        present[row] = false;
+        values[row].clear();
+    }
+}
+
+auto task_table::size() const noexcept -> size_type
+{
+    return fields_.size();
+}
+
+auto task_table::empty() const noexcept -> bool
+{
+    return fields_.empty();
+}
+
+auto task_table::clear() -> void
+{
+    id_.clear();
+    group_.clear();
+    cpu_.clear();
+    deadline_.clear();
+    size_.clear();
+    status_.clear();
+    fields_.clear();
+    group_names_.clear();
+    group_index_.clear();
+    header_.clear();
+    body_.clear();
+    text_.clear();
+}
+
+auto task_table::reserve(size_type n) -> void
+{
+    id_.reserve(n);
+    group_.reserve(n);
+    cpu_.reserve(n);
+    deadline_.reserve(n);
+    size_.reserve(n);
+    status_.reserve(n);
+    fields_.reserve(n);
+}
+
+auto task_table::emplace_row() -> size_type
+{
+    id_.emplace_back();
+    group_.push_back(0);
+    cpu_.push_back(0);
+    deadline_.push_back(0);
+    size_.push_back(0);
+    status_.push_back(0);
+    fields_.push_back(0);
+    return fields_.size() - 1;
+}
+
+auto task_table::append(const json& item) -> size_type
+{
+    auto row = emplace_row();
+    if (item.contains("header") && item["header"].is_object()) {
+        for (const auto& [key, value] : item["header"].items())
+            set_header(row, key, to_attribute_value(value));
+    }
+
+    if (item.contains("body") && item["body"].is_object()) {
+        for (const auto& [key, value] : item["body"].items())
+            set_body(row, key, to_attribute_value(value));
+    }
+
+    return row;
+}
+
+auto task_table::append(const task_table& other, size_type row) -> size_type
+{
+    auto r = emplace_row();
+    id_[r]       = other.id_[row];
+    cpu_[r]      = other.cpu_[row];
+    deadline_[r] = other.deadline_[row];
+    size_[r]     = other.size_[row];
+    status_[r]   = other.status_[row];
+    fields_[r]   = other.fields_[row];
+    if (other.fields_[row] & field_group)
+        group_[r] = intern(other.group_names_[other.group_[row]]);
+
+    for (const auto& [key, column] : other.header_) {
+        if (column.contains(row))
+            header_[key].set(r, column.values[row]);
+    }
+
+    for (const auto& [key, column] : other.text_) {
+        if (column.contains(row))
+            text_[key].set(r, column.values[row]);
+    }
+
+    for (const auto& [key, column] : other.body_) {
+        if (column.contains(row))
+            body_[key].set(r, column.values[row]);
+    }
+
+    return r;
+}
+
+auto task_table::get_header(size_type row, std::string_view key) const -> std::string
+{
+    if (auto f = field_of(key); f && (fields_[row] & f))
+        return get_field(row, f);
+
+    return get(header_, row, key);
+}
+
+auto task_table::set_header(size_type row, std::string_view key, std::string_view value) -> void
+{
+    if (auto f = field_of(key)) {
+        if (set_field(row, f, value)) {
+            erase(header_, row, key);
+            // 保留原文，如 "100000" 不读回为 "1e+05"
+            erase(text_, row, key);
+            if (f != field_task_id && f != field_group && get_field(row, f) != value)
+                set(text_, row, key, value);
+            return;
+        }
+
+        // 非数值，放入附加属性列
+        fields_[row] &= ~f;
+        erase(text_, row, key);
+    }
+
+    set(header_, row, key, value);
+}
+
+auto task_table::has_header(size_type row, std::string_view key) const -> bool
+{
+    if (auto f = field_of(key); f && (fields_[row] & f))
+        return true;
+
+    auto it = header_.find(key);
+    return it != header_.end() && it->second.contains(row);
+}
+
+auto task_table::header_equals(size_type row, std::string_view key, std::string_view value) const -> bool
+{
+    auto f = field_of(key);
+    if (!f || !(fields_[row] & f))
+        return has_header(row, key) && get(header_, row, key) == value;
+
+    switch (f) {
+    case field_task_id: {
+        auto id = task_id::from_string(value);
+        return id && *id == id_[row];
+    }
+    case field_group:
+        return group_names_[group_[row]] == value;
+    case field_status: {
+        int v{};
+        return parse_number(value, v) && v == status_[row];
+    }
+    default: {
+        double v{};
+        const auto& column = f == field_cpu ? cpu_ : f == field_deadline ? deadline_ : size_;
+        return parse_number(value, v) && v == column[row];
+    }
+    }
+}
+
+auto task_table::get_body(size_type row, std::string_view key) const -> std::string
+{
+    return get(body_, row, key);
+}
+
+auto task_table::set_body(size_type row, std::string_view key, std::string_view value) -> void
+{
+    set(body_, row, key, value);
+}
+
+auto task_table::header_attributes(size_type row) const -> std::vector<attribute_type>
+{
+    static constexpr std::array typed_fields {
+        std::pair{ field_task_id,  std::string_view{"task_id"} },
+        std::pair{ field_group,    std::string_view{"group"} },
+        std::pair{ field_cpu,      std::string_view{"cpu"} },
+        std::pair{ field_deadline, std::string_view{"deadline"} },
+        std::pair{ field_size,     std::string_view{"size"} },
+        std::pair{ field_status,   std::string_view{"status"} },
+    };
+
+    std::vector<attribute_type> result;
+    for (auto [f, name] : typed_fields) {
+        if (fields_[row] & f)
+            result.emplace_back(name, get_field(row, f));
+    }
+
+    collect(header_, row, result);
+    std::ranges::sort(result, {}, &attribute_type::first);
+    return result;
+}
+
+auto task_table::body_attributes(size_type row) const -> std::vector<attribute_type>
+{
+    std::vector<attribute_type> result;
+    collect(body_, row, result);
+    return result;
+}
+
+auto task_table::to_json(size_type row) const -> json
+{
+    json item;
+    item["header"] = json::object();
+    for (auto& [key, value] : header_attributes(row))
+        item["header"][key] = std::move(value);
+
+    for (auto& [key, value] : body_attributes(row))
+        item["body"][key] = std::move(value);
+
+    return item;
+}
+
+auto task_table::id(size_type row) const -> task_id
+{
+    if (fields_[row] & field_task_id)
+        return id_[row];
+
+    // 非标准格式的 id 存放在附加属性列中
+    return has_header(row, "task_id") ? task_id::of(get(header_, row, "task_id")) : task_id{};
+}
+
+auto task_table::group(size_type row) const -> const std::string&
+{
+    static const std::string none{};
+    return fields_[row] & field_group ? group_names_[group_[row]] : none;
+}
+
+auto task_table::cpu(size_type row) const -> double
+{
+    return cpu_[row];
+}
+
+auto task_table::deadline(size_type row) const -> double
+{
+    return deadline_[row];
+}
+
+auto task_table::data_size(size_type row) const -> double
+{
+    return size_[row];
+}
+
+auto task_table::status(size_type row) const -> int
+{
+    return fields_[row] & field_status ? status_[row] : -1;
+}
+
+auto task_table::set_status(size_type row, int value) -> bool
+{
+    if (value < 0 || value > 0xFF)
+        return false;
+
+    status_[row] = static_cast<std::uint8_t>(value);
+    fields_[row] |= field_status;
+    erase(header_, row, "status");
+    erase(text_, row, "status");
+    return true;
+}
+
+auto task_table::field_of(std::string_view key) -> std::uint8_t
+{
+    if (key == "task_id")  return field_task_id;
+    if (key == "group")    return field_group;
+    if (key == "cpu")      return field_cpu;
+    if (key == "deadline") return field_deadline;
+    if (key == "size")     return field_size;
+    if (key == "status")   return field_status;
+    return 0;
+}
+
+auto task_table::intern(std::string_view name) -> std::uint32_t
+{
+    auto key = std::string(name);
+    if (auto it = group_index_.find(key); it != group_index_.end())
+        return it->second;
+
+    auto index = static_cast<std::uint32_t>(group_names_.size());
+    group_names_.push_back(key);
+    group_index_.emplace(std::move(key), index);
+    return index;
+}
+
+auto task_table::set_field(size_type row, std::uint8_t f, std::string_view value) -> bool
+{
+    switch (f) {
+    case field_task_id:
+        if (auto id = task_id::from_string(value))
+            id_[row] = *id;
+        else
+            return false;
+        break;
+    case field_group:
+        group_[row] = intern(value);
+        break;
+    case field_cpu:
+        if (!parse_number(value, cpu_[row])) return false;
+        break;
+    case field_deadline:
+        if (!parse_number(value, deadline_[row])) return false;
+        break;
+    case field_size:
+        if (!parse_number(value, size_[row])) return false;
+        break;
+    case field_status:
+        if (int v{}; parse_number(value, v) && v >= 0 && v <= 0xFF)
+            status_[row] = static_cast<std::uint8_t>(v);
+        else
+            return false;
+        break;
+    default:
+        return false;
     }
-    else
-        elem_ = nullptr;
+
+    fields_[row] |= f;
+    return true;
 }
 
-task_element::task_element(const task_element& other) noexcept
+auto task_table::get_field(size_type row, std::uint8_t f) const -> std::string
 {
-    if (this != &other) {
-        elem_ = new json(*other.elem_); // copy
-        is_dynamically_allocated = true;
+    static constexpr std::string_view numeric_keys[] { "cpu", "deadline", "size", "status" };
+    if (f != field_task_id && f != field_group && !text_.empty()) {
+        auto key = numeric_keys[f == field_cpu ? 0 : f == field_deadline ? 1 : f == field_size ? 2 : 3];
+        if (auto it = text_.find(key); it != text_.end() && it->second.contains(row))
+            return it->second.values[row];
+    }
+
+    switch (f) {
+    case field_task_id:  return id_[row].to_string();
+    case field_group:    return group_names_[group_[row]];
+    case field_cpu:      return format_number(cpu_[row]);
+    case field_deadline: return format_number(deadline_[row]);
+    case field_size:     return format_number(size_[row]);
+    case field_status:   return std::to_string(status_[row]);
+    default:             return {};
     }
 }
 
-task_element& task_element::operator=(const task_element& other) noexcept
+auto task_table::get(const attribute_columns& columns, size_type row, std::string_view key) -> std::string
+{
+    if (auto it = columns.find(key); it != columns.end() && it->second.contains(row))
+        return it->second.values[row];
+
+    return {};
+}
+
+auto task_table::set(attribute_columns& columns, size_type row, std::string_view key, std::string_view value) -> void
 {
-    if (this != &other) {
-        elem_ = new json(*other.elem_); // copy
-        is_dynamically_allocated = true;
+    auto it = columns.find(key);
+    if (it == columns.end())
+        it = columns.emplace(std::string(key), attribute_column{}).first;
+
+    it->second.set(row, value);
+}
+
+auto task_table::erase(attribute_columns& columns, size_type row, std::string_view key) -> void
+{
+    if (auto it = columns.find(key); it != columns.end())
+        it->second.erase(row);
+}
+
+auto task_table::collect(const attribute_columns& columns, size_type row, std::vector<attribute_type>& out) -> void
+{
+    for (const auto& [key, column] : columns) {
+        if (column.contains(row))
+            out.emplace_back(key, column.values[row]);
     }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// task_element
+//////////////////////////////////////////////////////////////////////////////
+
+task_element::task_element() noexcept
+    : table_{ nullptr }
+    , row_{ 0 }
+{
+}
+
+task_element::task_element(std::nullptr_t) noexcept
+    : task_element()
+{
+}
+
+task_element::task_element(json item)
+    : task_element()
+{
+    if (item.contains("/header"_json_pointer)) {
+        owner_ = std::make_shared<task_table>();
+        row_ = owner_->append(item);
+        table_ = owner_.get();
+    }
+}
+
+task_element::task_element(task* owner, std::size_t row) noexcept
+    : task_{ owner }
+    , table_{ nullptr }
+    , row_{ row }
+{
+}
+
+task_element::task_element(std::shared_ptr<task_table> table, std::size_t row) noexcept
+    : table_{ table.get() }
+    , row_{ row }
+    , owner_{ std::move(table) }
+{
+}
+
+task_element::task_element(const task_element& other)
+    : table_{ other.task_ ? nullptr : other.table_ }
+    , row_{ other.row_ }
+    , owner_{ other.owner_ }
+{
+    // 视图没有所有权，拷贝时复制该行
+    if (auto table = other.table(); table && !owner_) {
+        owner_ = std::make_shared<task_table>();
+        row_ = owner_->append(*table, other.row_);
+        table_ = owner_.get();
+    }
+}
+
+task_element& task_element::operator=(const task_element& other)
+{
+    if (this != &other)
+        *this = task_element(other);
 
     return *this;
 }
 
 task_element::task_element(task_element&& other) noexcept
-    : elem_ { std::exchange(other.elem_, nullptr) }
-    , is_dynamically_allocated { std::exchange(other.is_dynamically_allocated, false) }
+    : task_ { std::exchange(other.task_, nullptr) }
+    , table_ { std::exchange(other.table_, nullptr) }
+    , row_ { std::exchange(other.row_, 0) }
+    , owner_ { std::move(other.owner_) }
 {
 }
 
 task_element& task_element::operator=(task_element&& other) noexcept
 {
-    elem_ = std::exchange(other.elem_, nullptr);
-    is_dynamically_allocated = std::exchange(other.is_dynamically_allocated, false);
+    task_ = std::exchange(other.task_, nullptr);
+    table_ = std::exchange(other.table_, nullptr);
+    row_ = std::exchange(other.row_, 0);
+    owner_ = std::move(other.owner_);
     return *this;
 }
 
-task_element::~task_element()
-{
-    if (elem_ != nullptr && is_dynamically_allocated)
-        delete elem_;
-}
+task_element::~task_element() = default;
 
 auto task_element::get_header(const std::string& key) const -> std::string
 {
-    std::string result{};
-    json::json_pointer j_key{ "/header/" + key };
-    if (elem_ && elem_->contains(j_key))
-        elem_->at(j_key).get_to(result);
-    
-    return result;
+    auto table = this->table();
+    return table ? table->get_header(row_, key) : std::string{};
 }
 
 auto task_element::set_header(std::string_view key, std::string_view value) -> bool
 {
-    if (elem_) {
-        json::json_pointer j_key{ "/header/" + std::string(key) };
-        (*elem_)[j_key] = value;
+    if (this->table()) {
+        detach();
+        table_->set_header(row_, key, value);
         return true;
     }
 
@@ -101,33 +539,99 @@ auto task_element::set_header(std::string_view key, std::string_view value) -> b
 
 auto task_element::get_body(const std::string& key) const -> std::string
 {
-    std::string result{};
-    json::json_pointer j_key{ "/body/" + key };
-    if (elem_ && elem_->contains(j_key))
-        elem_->at(j_key).get_to(result);
-    
-    return result;
+    auto table = this->table();
+    return table ? table->get_body(row_, key) : std::string{};
 }
 
 auto task_element::set_body(std::string_view key, std::string_view value) -> bool
 {
-    if (elem_) {
-        json::json_pointer j_key{ "/body/" + std::string(key) };
-        (*elem_)[j_key] = value;
+    if (this->table()) {
+        detach();
+        table_->set_body(row_, key, value);
         return true;
     }
 
     return false;
 }
 
+auto task_element::get_id() const -> task_id
+{
+    auto table = this->table();
+    return table ? table->id(row_) : task_id{};
+}
+
+auto task_element::get_group() const -> std::string
+{
+    auto table = this->table();
+    return table ? table->group(row_) : std::string{};
+}
+
+auto task_element::get_cpu() const -> double
+{
+    auto table = this->table();
+    return table ? table->cpu(row_) : 0;
+}
+
+auto task_element::get_deadline() const -> double
+{
+    auto table = this->table();
+    return table ? table->deadline(row_) : 0;
+}
+
+auto task_element::get_size() const -> double
+{
+    auto table = this->table();
+    return table ? table->data_size(row_) : 0;
+}
+
+auto task_element::get_status() const -> int
+{
+    auto table = this->table();
+    return table ? table->status(row_) : -1;
+}
+
+auto task_element::set_status(int value) -> bool
+{
+    if (this->table()) {
+        if (value < 0 || value > 0xFF)
+            return false;
+        detach();
+        return table_->set_status(row_, value);
+    }
+
+    return false;
+}
+
 auto task_element::j_data() const -> json
 {
-    return elem_ ? *elem_ : json{};
+    auto table = this->table();
+    return table ? table->to_json(row_) : json{};
 }
 
 auto task_element::empty() const -> bool
 {
-    return elem_;
+    return this->table() == nullptr;
+}
+
+auto task_element::table() const noexcept -> task_table*
+{
+    return task_ ? task_->m_table.get() : table_;
+}
+
+auto task_element::detach() -> void
+{
+    // 视图经由任务写入，任务与其他副本或句柄共享时先复制整张表
+    if (task_) {
+        table_ = &task_->mutable_table();
+        return;
+    }
+
+    if (owner_ && owner_.use_count() > 1) {
+        auto table = std::make_shared<task_table>();
+        row_ = table->append(*owner_, row_);
+        owner_ = std::move(table);
+        table_ = owner_.get();
+    }
 }
 
 auto task_element::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task_element
@@ -142,15 +646,25 @@ auto task_element::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task_element
 auto task_element::dump(int indent) const -> std::string
 {
     std::string result{};
-    if (!elem_->is_null())
-        result = elem_->dump(indent);
+    if (this->table())
+        result = j_data().dump(indent);
     return result;
 }
 
+
+//////////////////////////////////////////////////////////////////////////////
+// task
+//////////////////////////////////////////////////////////////////////////////
+
+task::task()
+    : m_table{ std::make_shared<task_table>() }
+{
+}
+
 task::task(json other)
+    : task()
 {
-    if (other.contains("/task/items"_json_pointer))
-        m_task = std::move(other);
+    import(other);
 }
 
 auto task::from_packet(ns3::Ptr<ns3::Packet> packet) -> task
@@ -170,31 +684,30 @@ auto task::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task
 
 auto task::emplace_back(task_header header_attrs, task_body body_attrs) -> void
 {
-    json item;
+    auto& table = mutable_table();
+    auto row = table.emplace_row();
     // Set header attributes
-    for (auto [key, value] : header_attrs) {
-        item["header"][key] = value;
+    for (const auto& [key, value] : header_attrs) {
+        table.set_header(row, key, value);
     }
 
     // Set body attributes
-    for (auto [key, value] : body_attrs) {
-        item["body"][key] = value;
+    for (const auto& [key, value] : body_attrs) {
+        table.set_body(row, key, value);
     }
-
-    m_task["task"]["items"].emplace_back(std::move(item));
 }
 
 auto task::dump(int indent) const -> std::string
 {
-    return m_task.dump(indent);
+    return j_data().dump(indent);
 }
 
 auto task::elements_view() -> std::vector<task_element>
 {
     std::vector<task_element> items;
     items.reserve(this->size());
-    for (json& item : m_task["task"]["items"])
-        items.emplace_back(task_element(&item));
+    for (std::size_t row = 0; row < m_table->size(); ++row)
+        items.emplace_back(this, row);
 
     return items;
 }
@@ -204,88 +717,80 @@ auto task::elements() const -> std::vector<task_element>
     std::vector<task_element> items;
     items.reserve(this->size());
 
-    for (const json& item : m_task["task"]["items"])
-        items.emplace_back(task_element(item));
+    for (std::size_t row = 0; row < m_table->size(); ++row)
+        items.emplace_back(m_table, row);
 
     return items;
 }
 
 auto task::at(std::size_t index) noexcept -> task_element
 {
-    return task_element(&m_task["task"]["items"].at(index));
+    return task_element(this, index);
 }
 
 auto task::at(std::size_t index) const noexcept -> task_element
 {
-    return task_element(m_task["task"]["items"].at(index));
+    return task_element(m_table, index);
 }
 
 auto task::data() const -> json
 {
-    return m_task["task"]["items"];
+    json items = json::array();
+    for (std::size_t row = 0; row < m_table->size(); ++row)
+        items.emplace_back(m_table->to_json(row));
+
+    return items;
 }
 
 auto task::j_data() const -> json
 {
-    return m_task;
+    json result;
+    result["task"]["items"] = this->data();
+    return result;
+}
+
+auto task::table() const noexcept -> const task_table&
+{
+    return *m_table;
 }
 
 auto task::is_null() const -> bool
 {
-    return m_task.is_null();
+    return m_table->empty();
 }
 
 auto task::size() const -> std::size_t
 {
-    if (m_task.contains("/task/items"_json_pointer))
-        return m_task["task"]["items"].size();
-
-    return 0;
+    return m_table->size();
 }
 
-auto task::set_if(attributes_t values, auto f) -> void
+auto task::empty() const -> bool
 {
-    for (auto& item : m_task["task"]["items"]) {
-        bool cond{true};
-        for (auto [key, value] : values) {
-            if (item[key] != value)
-                cond = false;
-        }
-
-        if (cond) {
-            f(item);
-            break;
-        }
-    }
+    return m_table->empty();
 }
 
-auto task::find_if(attributes_t values) -> task
+auto task::find_if(attributes_t values) const -> task
 {
     task result{};
-    for (const auto& item : m_task["task"]["items"]) {
-        bool cond{true};
-        for (auto [key, value] : values) {
-            if (item[key] != value)
-                cond = false;
-        }
-
-        if (cond) {
-            result.push_back(item);
-        }
+    for (std::size_t row = 0; row < m_table->size(); ++row) {
+        if (match(row, values))
+            result.m_table->append(*m_table, row);
     }
+
     return result;
 }
 
-auto task::find_if(attribute_t value) -> task
+auto task::find_if(attribute_t value) const -> task
 {
     return find_if({value});
 }
+
 // status 0
-auto task::contains(attributes_t values) -> bool
+auto task::contains(attributes_t values) const -> bool
 {
-    for (auto& item : m_task["task"]["items"]) {
-        for (auto [key, value] : values) {
-            if (item["header"][key] == value)
+    for (std::size_t row = 0; row < m_table->size(); ++row) {
+        for (const auto& [key, value] : values) {
+            if (m_table->header_equals(row, key, value))
                 return true;
         }
     }
@@ -293,7 +798,7 @@ auto task::contains(attributes_t values) -> bool
     return false;
 }
 
-auto task::contains(attribute_t value) -> bool
+auto task::contains(attribute_t value) const -> bool
 {
     return contains({value});
 }
@@ -318,43 +823,15 @@ auto task::get_body(const json& element, const std::string& key) -> std::string
     return result;
 }
 
-auto task::unique_id() -> std::string
+auto task::unique_id() -> task_id
 {
-    static std::random_device              rd;
-    static std::mt19937                    gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    static std::uniform_int_distribution<> dis2(8, 11);
-
-    std::stringstream ss;
-    int i;
-    ss << std::hex << std::uppercase;
-    for (i = 0; i < 8; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    for (i = 0; i < 4; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-4";
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    ss << dis2(gen);
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    for (i = 0; i < 12; i++) {
-        ss << dis(gen);
-    };
-    return ss.str();
+    return task_id::generate();
 }
 
 auto task::save_to_file(const std::string& file_name) -> void
 {
     std::ofstream fout(file_name);
-    fout << std::setw(4) << m_task << std::endl;
+    fout << std::setw(4) << j_data() << std::endl;
 }
 
 auto task::load_from_file(const std::string& file_name) -> bool
@@ -363,14 +840,8 @@ auto task::load_from_file(const std::string& file_name) -> bool
     if (!fin.is_open())
         return false;
 
-    json data;
-    fin >> data;
-
-    if (!data.contains("/task/items"_json_pointer))
-        return false;
-    
-    m_task = std::move(data);
-    return true;
+    json data = json::parse(fin, nullptr, false);
+    return !data.is_discarded() && this->import(data);
 }
 
 auto task::operator[](std::size_t index) noexcept -> task_element
@@ -383,10 +854,35 @@ auto task::operator[](std::size_t index) const noexcept -> task_element
     return this->at(index);
 }
 
-auto task::push_back(const json &sub) -> void
+auto task::match(std::size_t row, attributes_t values) const -> bool
+{
+    return std::ranges::all_of(values, [this, row](const attribute_t& value) {
+        return m_table->header_equals(row, value.first, value.second);
+    });
+}
+
+auto task::import(const json& j) -> bool
 {
-    m_task.push_back(sub);
+    if (!j.contains("/task/items"_json_pointer))
+        return false;
+
+    const auto& items = j["task"]["items"];
+    auto table = std::make_shared<task_table>();
+    table->reserve(items.size());
+    for (const auto& item : items)
+        table->append(item);
+
+    m_table = std::move(table);
+    return true;
+}
+
+auto task::mutable_table() -> task_table&
+{
+    if (m_table.use_count() > 1)
+        m_table = std::make_shared<task_table>(*m_table);
+
+    return *m_table;
 }
 
 
-} // namespace okec
\ No newline at end of file
+} // namespace okec
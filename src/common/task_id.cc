@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_id.h>
+#include <bit>
+#include <random>
+
+
+namespace okec
+{
+
+namespace {
+
+auto splitmix64(std::uint64_t& x) noexcept -> std::uint64_t
+{
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256**
+struct generator {
+    std::uint64_t s[4];
+
+    explicit generator(std::uint64_t seed) noexcept {
+        reseed(seed);
+    }
+
+    auto reseed(std::uint64_t seed) noexcept -> void {
+        for (auto& v : s)
+            v = splitmix64(seed);
+    }
+
+    auto operator()() noexcept -> std::uint64_t {
+        const std::uint64_t result = std::rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = std::rotl(s[3], 45);
+        return result;
+    }
+};
+
+auto global_generator() -> generator&
+{
+    static generator gen{ (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}() };
+    return gen;
+}
+
+auto hex_value(char c) noexcept -> int
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+} // namespace
+
+
+auto task_id::generate() noexcept -> task_id
+{
+    auto& gen = global_generator();
+    auto high = gen();
+    auto low = gen();
+    return task_id{ high, low };
+}
+
+auto task_id::seed(std::uint64_t value) noexcept -> void
+{
+    global_generator().reseed(value);
+}
+
+auto task_id::from_string(std::string_view sv) noexcept -> std::optional<task_id>
+{
+    if (sv.size() != 32)
+        return std::nullopt;
+
+    std::uint64_t half[2]{};
+    for (std::size_t i = 0; i < 32; ++i) {
+        auto v = hex_value(sv[i]);
+        if (v < 0)
+            return std::nullopt;
+        half[i / 16] = (half[i / 16] << 4) | static_cast<std::uint64_t>(v);
+    }
+
+    return task_id{ half[0], half[1] };
+}
+
+auto task_id::of(std::string_view sv) noexcept -> task_id
+{
+    if (auto id = from_string(sv))
+        return *id;
+
+    // FNV-1a over the text, spread to 128 bits
+    std::uint64_t h = 0xCBF29CE484222325ull;
+    for (unsigned char c : sv)
+        h = (h ^ c) * 0x100000001B3ull;
+
+    auto high = splitmix64(h);
+    auto low = splitmix64(h);
+    return task_id{ high, low };
+}
+
+auto task_id::to_string() const -> std::string
+{
+    static constexpr char digits[] = "0123456789ABCDEF";
+
+    std::string result(32, '0');
+    for (int i = 15; i >= 0; --i) {
+        result[i]      = digits[(high_ >> ((15 - i) * 4)) & 0xF];
+        result[i + 16] = digits[(low_ >> ((15 - i) * 4)) & 0xF];
+    }
+
+    return result;
+}
+
+
+} // namespace okec
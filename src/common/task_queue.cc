@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_queue.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/format_helper.hpp>
+#include <limits>
+
+
+namespace okec
+{
+
+auto task_queue::push(task_element item) -> void
+{
+    item.set_status(0); // 0: 未分发 1: 已分发
+    if (item.get_header("arrival_time").empty())
+        item.set_header("arrival_time", okec::format("{:.9f}", now::seconds()));
+
+    auto id = item.get_id();
+    this->erase(id); // 重复提交的任务只保留最新的一份
+    pending_.push_back(std::move(item));
+    auto pos = std::prev(pending_.end());
+    auto rank = this->ordered() ? order_.emplace(key_of(*pos), pos) : order_.end();
+    auto cpu = pos->get_cpu();
+    pending_cpu_ += cpu;
+    index_.emplace(id, entry{ pos, false, rank, cpu });
+}
+
+auto task_queue::front() -> task_element*
+{
+    if (!this->ordered())
+        return pending_.empty() ? nullptr : &pending_.front();
+    return order_.empty() ? nullptr : &*order_.begin()->second;
+}
+
+auto task_queue::set_order(queue_order order, estimate_type service_estimate) -> void
+{
+    order_kind_ = order;
+    service_estimate_ = std::move(service_estimate);
+
+    // 按新的顺序重建
+    order_.clear();
+    for (auto pos = pending_.begin(); pos != pending_.end(); ++pos)
+        index_[pos->get_id()].rank = this->ordered() ? order_.emplace(key_of(*pos), pos) : order_.end();
+}
+
+auto task_queue::order() const -> queue_order
+{
+    return order_kind_;
+}
+
+auto task_queue::absolute_deadline(const task_element& item) -> double
+{
+    auto deadline = item.get_deadline();
+    if (!(deadline > 0))
+        return std::numeric_limits<double>::infinity();
+
+    auto arrival = item.get_header("arrival_time");
+    return (arrival.empty() ? now::seconds() : std::stod(arrival)) + deadline;
+}
+
+auto task_queue::work_ahead(const task_element& item) const -> double
+{
+    // FIFO 下新任务排在所有 pending 任务之后
+    if (!this->ordered())
+        return pending_cpu_;
+
+    double key = absolute_deadline(item) - (order_kind_ == queue_order::least_laxity && service_estimate_ ? service_estimate_(item) : 0.0);
+
+    double work = 0.0;
+    for (auto it = order_.begin(); it != order_.end() && it->first <= key; ++it)
+        work += it->second->get_cpu();
+    return work;
+}
+
+auto task_queue::ordered() const -> bool
+{
+    return order_kind_ != queue_order::fifo;
+}
+
+auto task_queue::key_of(const task_element& item) -> double
+{
+    if (order_kind_ == queue_order::least_laxity)
+        return absolute_deadline(item) - (service_estimate_ ? service_estimate_(item) : 0.0);
+    return absolute_deadline(item);
+}
+
+auto task_queue::find(const task_id& id) -> task_element*
+{
+    auto it = index_.find(id);
+    return it == index_.end() ? nullptr : &*it->second.it;
+}
+
+auto task_queue::contains(const task_id& id) const -> bool
+{
+    return index_.contains(id);
+}
+
+auto task_queue::in_flight(const task_id& id) const -> bool
+{
+    auto it = index_.find(id);
+    return it != index_.end() && it->second.in_flight;
+}
+
+auto task_queue::dispatch(const task_id& id) -> bool
+{
+    auto it = index_.find(id);
+    if (it == index_.end() || it->second.in_flight)
+        return false;
+
+    auto& [pos, in_flight, rank, cpu] = it->second;
+    pos->set_status(1);
+    if (this->ordered())
+        order_.erase(rank);
+    in_flight_.splice(in_flight_.end(), pending_, pos);
+    in_flight = true;
+    pending_cpu_ = pending_.empty() ? 0.0 : pending_cpu_ - cpu;
+    return true;
+}
+
+auto task_queue::requeue(const task_id& id) -> bool
+{
+    auto it = index_.find(id);
+    if (it == index_.end() || !it->second.in_flight)
+        return false;
+
+    auto& [pos, in_flight, rank, cpu] = it->second;
+    pos->set_status(0);
+    pending_.splice(pending_.begin(), in_flight_, pos);
+    in_flight = false;
+    pending_cpu_ += cpu;
+
+    // FIFO 下排到最前面，截止时间顺序下回到原来的位置
+    if (this->ordered())
+        rank = order_.emplace(key_of(*pos), pos);
+    return true;
+}
+
+auto task_queue::erase(const task_id& id) -> bool
+{
+    auto it = index_.find(id);
+    if (it == index_.end())
+        return false;
+
+    auto [pos, in_flight, rank, cpu] = it->second;
+    if (!in_flight && this->ordered())
+        order_.erase(rank);
+    (in_flight ? in_flight_ : pending_).erase(pos);
+    if (!in_flight)
+        pending_cpu_ = pending_.empty() ? 0.0 : pending_cpu_ - cpu;
+    index_.erase(it);
+    return true;
+}
+
+auto task_queue::size() const -> std::size_t
+{
+    return index_.size();
+}
+
+auto task_queue::pending_size() const -> std::size_t
+{
+    return pending_.size();
+}
+
+auto task_queue::in_flight_size() const -> std::size_t
+{
+    return in_flight_.size();
+}
+
+auto task_queue::empty() const -> bool
+{
+    return index_.empty();
+}
+
+auto task_queue::pending() const -> const list_type&
+{
+    return pending_;
+}
+
+auto task_queue::in_flight() const -> const list_type&
+{
+    return in_flight_;
+}
+
+
+} // namespace okec
@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/workload.h>
+#include <okec/common/simulator.h>
+#include <okec/devices/client_device.h>
+#include <okec/utils/log.h>
+#include <algorithm>
+
+
+namespace okec
+{
+
+workload::workload(std::shared_ptr<client_device> client, std::shared_ptr<arrival_process> arrivals,
+    generator_type generator)
+    : client_{ std::move(client) },
+      arrivals_{ std::move(arrivals) },
+      generator_{ std::move(generator) }
+{
+}
+
+workload::~workload()
+{
+    event_.Cancel();
+}
+
+auto workload::limit(std::size_t n) -> workload&
+{
+    limit_ = n;
+    return *this;
+}
+
+auto workload::until(ns3::Time time) -> workload&
+{
+    until_ = time.GetSeconds();
+    return *this;
+}
+
+auto workload::start(ns3::Time offset) -> void
+{
+    schedule_next(offset.GetSeconds());
+}
+
+auto workload::stop() -> void
+{
+    event_.Cancel();
+}
+
+auto workload::generated() const -> std::size_t
+{
+    return generated_;
+}
+
+auto workload::schedule_next(double delay) -> void
+{
+    if (generated_ >= limit_)
+        return;
+
+    auto gap = arrivals_->next();
+    if (!gap)
+        return;
+
+    delay += *gap;
+    if (now::seconds() + delay > until_)
+        return;
+
+    event_ = ns3::Simulator::Schedule(ns3::Seconds(delay), [this] {
+        arrive();
+    });
+}
+
+auto workload::arrive() -> void
+{
+    client_->launch(generator_(generated_++));
+    schedule_next(0.0);
+}
+
+
+
+trace_replay::trace_replay(std::shared_ptr<client_device> client, csv_reader reader,
+    std::string_view time_column, builder_type builder)
+    : trace_replay(std::move(client), std::move(reader), std::size_t{}, std::move(builder))
+{
+    time_column_ = reader_.column(time_column).value_or(static_cast<std::size_t>(-1));
+    if (time_column_ == static_cast<std::size_t>(-1))
+        log::error("trace_replay: no column named {}", time_column);
+}
+
+trace_replay::trace_replay(std::shared_ptr<client_device> client, csv_reader reader,
+    std::size_t time_column, builder_type builder)
+    : client_{ std::move(client) },
+      reader_{ std::move(reader) },
+      time_column_{ time_column },
+      builder_{ std::move(builder) }
+{
+}
+
+trace_replay::~trace_replay()
+{
+    event_.Cancel();
+}
+
+auto trace_replay::limit(std::size_t n) -> trace_replay&
+{
+    limit_ = n;
+    return *this;
+}
+
+auto trace_replay::start(ns3::Time offset) -> void
+{
+    origin_ = now::seconds() + offset.GetSeconds();
+    it_ = reader_.begin();
+    schedule_next();
+}
+
+auto trace_replay::stop() -> void
+{
+    event_.Cancel();
+}
+
+auto trace_replay::generated() const -> std::size_t
+{
+    return generated_;
+}
+
+auto trace_replay::skipped() const -> std::size_t
+{
+    return skipped_;
+}
+
+auto trace_replay::schedule_next() -> void
+{
+    for (; generated_ < limit_ && it_ != reader_.end(); ++it_) {
+        auto at = it_->get<double>(time_column_);
+        if (!at) {
+            ++skipped_;
+            continue;
+        }
+
+        auto delay = std::max(0.0, origin_ + *at - now::seconds());
+        event_ = ns3::Simulator::Schedule(ns3::Seconds(delay), [this] {
+            arrive();
+        });
+        return;
+    }
+}
+
+auto trace_replay::arrive() -> void
+{
+    ++generated_;
+    client_->launch(builder_(*it_));
+    ++it_;
+    schedule_next();
+}
+
+} // namespace okec
@@ -88,12 +88,26 @@ auto base_station::set_request_handler(std::string_view msg_type, callback_type
         });
 }
 
+auto base_station::set_request_handler(std::string_view msg_type, message_callback_type callback) -> void
+{
+    m_udp_application->set_request_handler(msg_type,
+        [callback, this](message& msg, ns3::Ptr<ns3::Packet>, const ns3::Address& remote_address) {
+            callback(this, msg, remote_address);
+        });
+}
+
 auto base_station::set_es_request_handler(std::string_view msg_type, es_callback_type callback) -> void
 {
     for (auto it = m_edge_devices->begin(); it != m_edge_devices->end(); it++)
         (*it)->set_request_handler(msg_type, callback);
 }
 
+auto base_station::set_es_request_handler(std::string_view msg_type, es_message_callback_type callback) -> void
+{
+    for (auto it = m_edge_devices->begin(); it != m_edge_devices->end(); it++)
+        (*it)->set_request_handler(msg_type, callback);
+}
+
 auto base_station::set_position(double x, double y, double z) -> void
 {
     ns3::Ptr<ns3::MobilityModel> mobility = m_node->GetObject<ns3::MobilityModel>();
@@ -129,26 +143,19 @@ auto base_station::write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destinat
 
 auto base_station::task_sequence(const task_element& item) -> void
 {
-    m_task_sequence.push_back(item);
-    m_task_sequence_status.push_back(0); // 0 means not dispatched.
+    m_task_sequence.push(item);
 }
 
 auto base_station::task_sequence(task_element&& item) -> void
 {
-    m_task_sequence.emplace_back(std::move(item));
-    m_task_sequence_status.push_back(0); // 0 means not dispatched.
+    m_task_sequence.push(std::move(item));
 }
 
-auto base_station::task_sequence() -> std::vector<task_element>&
+auto base_station::task_sequence() -> task_queue&
 {
     return m_task_sequence;
 }
 
-auto base_station::task_sequence_status() -> std::vector<char>&
-{
-    return m_task_sequence_status;
-}
-
 auto base_station::print_task_info() -> void
 {
     // okec::print("Task sequence size: {}\n", m_task_sequence.size());
@@ -208,6 +215,11 @@ base_station_container::base_station_container(simulator& sim, std::size_t n)
     }
 }
 
+base_station_container::base_station_container(std::vector<pointer_t> base_stations)
+    : m_base_stations{ std::move(base_stations) }
+{
+}
+
 auto base_station_container::operator[](std::size_t index) -> pointer_t
 {
     return this->get(index);
@@ -238,6 +250,15 @@ auto base_station_container::set_request_handler(
     });
 }
 
+auto base_station_container::set_request_handler(
+    std::string_view msg_type, message_callback_type callback) -> void
+{
+    std::ranges::for_each(m_base_stations,
+        [&msg_type, callback](pointer_t bs) {
+        bs->set_request_handler(msg_type, callback);
+    });
+}
+
 auto base_station_container::set_es_request_handler(
     std::string_view msg_type, es_callback_type callback) -> void
 {
@@ -247,6 +268,15 @@ auto base_station_container::set_es_request_handler(
     });
 }
 
+auto base_station_container::set_es_request_handler(
+    std::string_view msg_type, es_message_callback_type callback) -> void
+{
+    std::ranges::for_each(m_base_stations,
+        [&msg_type, callback](pointer_t bs) {
+        bs->set_es_request_handler(msg_type, callback);
+    });
+}
+
 auto base_station_container::set_decision_engine(std::shared_ptr<decision_engine> engine) -> void
 {
     for (pointer_t bs : m_base_stations) {
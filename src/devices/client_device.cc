@@ -12,6 +12,7 @@
 #include <okec/common/resource.h>
 #include <okec/devices/base_station.h>
 #include <okec/network/udp_application.h>
+#include <okec/common/arrival_process.h>
 #include <okec/common/awaitable.h>
 #include <okec/common/response.h>
 #include <okec/common/simulator.h>
@@ -70,18 +71,41 @@ auto client_device::send(task t) -> void
     }
 }
 
-auto client_device::async_send(task t) -> std::suspend_never
+auto client_device::async_send(task t) -> send_awaiter
 {
+    completion_token first{};
     for (auto&& item : t.elements_view()) {
+        auto group = item.get_group();
         m_decision_engine->send(std::move(item), shared_from_this());
+
+        // 这些组的响应在被读取前会暂存下来
+        if (auto token = m_response.token(group)) {
+            m_expected.insert(token);
+            if (!first)
+                first = token;
+        }
     }
 
-    return {};
+    return send_awaiter{ first };
+}
+
+auto client_device::launch(task t) -> void
+{
+    m_launching = true;
+    for (auto&& item : t.elements_view()) {
+        m_decision_engine->send(std::move(item), shared_from_this());
+    }
+    m_launching = false;
 }
 
 auto client_device::async_read() -> response_awaiter
 {
-    return response_awaiter{sim_, okec::format("{:ip}", this->get_address())};
+    return response_awaiter{ *this };
+}
+
+auto client_device::async_read(completion_token token) -> response_awaiter
+{
+    return response_awaiter{ *this, token };
 }
 
 auto client_device::async_read(done_callback_t fn) -> void
@@ -89,18 +113,102 @@ auto client_device::async_read(done_callback_t fn) -> void
     m_done_fn = fn;
 }
 
-auto client_device::when_done(response_type resp) -> void
+auto client_device::when_done(completion_token token, response_type resp) -> void
 {
-    auto ip = okec::format("{:ip}", this->get_address());
-    if (sim_.is_valid(ip)) {
-        sim_.complete(ip, std::move(resp));
+    bool expected = m_expected.erase(token) > 0;
+    bool abandoned = m_abandoned.erase(token) > 0;
+    bool delivered = false;
+
+    // 先摘下所有要唤醒的协程，恢复执行时它们可能会再次注册等待
+    std::vector<completion_waiter> ready;
+    std::erase_if(m_waiters, [&](const auto& waiter) {
+        if (waiter.first != token)
+            return false;
+        ready.push_back(waiter.second);
+        return true;
+    });
+
+    // 恢复执行的协程可能放弃了快照中的其他等待者，cancel_completion 会把它们标记为空
+    auto outer = std::exchange(m_resuming, &ready);
+    for (std::size_t i = 0; i < ready.size(); ++i) {
+        auto waiter = ready[i];
+        if (!waiter.result)
+            continue;
+
+        *waiter.result = resp;
+        delivered = true;
+        waiter.handle.resume();
+    }
+    m_resuming = outer;
+
+    // 放弃读取的组不交给无关的 async_read()
+    if (!delivered && !abandoned && !m_any_waiters.empty()) {
+        auto waiter = m_any_waiters.front();
+        m_any_waiters.pop_front();
+        *waiter.result = resp;
+        delivered = true;
+        waiter.handle.resume();
     }
 
+    if (!delivered && expected)
+        m_completed.emplace_back(token, resp);
+
     if (this->has_done_callback()) {
         std::invoke(m_done_fn, std::move(resp));
     }
 }
 
+auto client_device::take_completed(completion_token token, response_type& out) -> bool
+{
+    auto it = std::ranges::find_if(m_completed, [token](const auto& item) {
+        return token == 0 || item.first == token;
+    });
+    if (it == m_completed.end())
+        return false;
+
+    out = std::move(it->second);
+    m_completed.erase(it);
+    return true;
+}
+
+auto client_device::await_completion(completion_token token, std::coroutine_handle<> handle, response_type* out) -> void
+{
+    if (token == 0) {
+        m_any_waiters.push_back({ handle, out });
+        return;
+    }
+
+    // 又有人等待这个组，响应重新暂存
+    if (m_abandoned.erase(token))
+        m_expected.insert(token);
+    m_waiters.push_back({ token, { handle, out } });
+}
+
+auto client_device::cancel_completion(response_type* out) -> void
+{
+    if (m_resuming) {
+        for (auto& waiter : *m_resuming) {
+            if (waiter.result == out)
+                waiter.result = nullptr;
+        }
+    }
+
+    std::erase_if(m_any_waiters, [out](const auto& waiter) { return waiter.result == out; });
+
+    auto it = std::ranges::find_if(m_waiters, [out](const auto& waiter) { return waiter.second.result == out; });
+    if (it == m_waiters.end())
+        return;
+
+    auto token = it->first;
+    m_waiters.erase(it);
+
+    // 最后一个等待者放弃后，该组的响应不再暂存
+    if (std::ranges::none_of(m_waiters, [token](const auto& waiter) { return waiter.first == token; })) {
+        m_expected.erase(token);
+        m_abandoned.insert(token);
+    }
+}
+
 auto client_device::set_position(double x, double y, double z) -> void
 {
     ns3::Ptr<ns3::MobilityModel> mobility = m_node->GetObject<ns3::MobilityModel>();
@@ -124,6 +232,28 @@ auto client_device::set_decision_engine(std::shared_ptr<decision_engine> engine)
     m_decision_engine = engine;
 }
 
+auto client_device::set_arrival_process(std::shared_ptr<arrival_process> arrivals) -> void
+{
+    m_arrivals = std::move(arrivals);
+}
+
+auto client_device::get_arrival_process() const -> std::shared_ptr<arrival_process>
+{
+    return m_arrivals;
+}
+
+auto client_device::next_launch_delay() -> double
+{
+    if (m_launching || !m_arrivals)
+        return 0.0;
+
+    double now = now::seconds();
+    if (auto gap = m_arrivals->next())
+        m_next_launch = std::max(m_next_launch, now) + *gap;
+
+    return std::max(0.0, m_next_launch - now);
+}
+
 auto client_device::set_request_handler(std::string_view msg_type, callback_type callback) -> void
 {
     m_udp_application->set_request_handler(msg_type, 
@@ -132,12 +262,20 @@ auto client_device::set_request_handler(std::string_view msg_type, callback_type
         });
 }
 
+auto client_device::set_request_handler(std::string_view msg_type, message_callback_type callback) -> void
+{
+    m_udp_application->set_request_handler(msg_type,
+        [callback, this](message& msg, ns3::Ptr<ns3::Packet>, const ns3::Address& remote_address) {
+            callback(this, msg, remote_address);
+        });
+}
+
 auto client_device::dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void
 {
     m_udp_application->dispatch(msg_type, packet, address);
 }
 
-auto client_device::response_cache() -> response_type&
+auto client_device::response_cache() -> response_tracker&
 {
     return m_response;
 }
@@ -201,4 +339,13 @@ auto client_device_container::set_request_handler(std::string_view msg_type, cal
     });
 }
 
+auto client_device_container::set_request_handler(std::string_view msg_type, message_callback_type callback)
+    -> void
+{
+    std::ranges::for_each(m_devices,
+        [&msg_type, callback](pointer_type client) {
+        client->set_request_handler(msg_type, callback);
+    });
+}
+
 } // namespace okec
\ No newline at end of file
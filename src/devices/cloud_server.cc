@@ -93,6 +93,14 @@ auto cloud_server::set_request_handler(std::string_view msg_type, callback_type
         });
 }
 
+auto cloud_server::set_request_handler(std::string_view msg_type, message_callback_type callback) -> void
+{
+    m_udp_application->set_request_handler(msg_type,
+        [callback, this](message& msg, ns3::Ptr<ns3::Packet>, const ns3::Address& remote_address) {
+            callback(this, msg, remote_address);
+        });
+}
+
 auto cloud_server::write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) const -> void
 {
     m_udp_application->write(packet, destination, port);
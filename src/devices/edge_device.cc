@@ -90,6 +90,14 @@ auto edge_device::set_request_handler(std::string_view msg_type, callback_type c
         });
 }
 
+auto edge_device::set_request_handler(std::string_view msg_type, message_callback_type callback) -> void
+{
+    m_udp_application->set_request_handler(msg_type,
+        [callback, this](message& msg, ns3::Ptr<ns3::Packet>, const ns3::Address& remote_address) {
+            callback(this, msg, remote_address);
+        });
+}
+
 auto edge_device::write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) const -> void
 {
     m_udp_application->write(packet, destination, port);
@@ -110,7 +118,8 @@ auto edge_device::on_get_resource_information(ns3::Ptr<ns3::Packet> packet, cons
         { "port", okec::format("{}", this->get_port()) },
         { "pos_x", okec::format("{}", get_position().x) },
         { "pos_y", okec::format("{}", get_position().y) },
-        { "pos_z", okec::format("{}", get_position().z) }
+        { "pos_z", okec::format("{}", get_position().z) },
+        { "version", std::to_string(device_resource->version()) }
     };
     msg.content(*device_resource);
     this->write(msg.to_packet(), ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4(), 8860);
@@ -8,11 +8,11 @@
 // Licenced under Apache-2.0 license. See LICENSE.txt for details.
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <okec/common/message.h>
 #include <okec/common/task.h>
 #include <okec/network/udp_application.h>
 #include <okec/utils/format_helper.hpp>
 #include <okec/utils/log.h>
-#include <okec/utils/message_helper.hpp>
 #include <ns3/arp-header.h>
 #include <ns3/csma-net-device.h>
 #include <ns3/ethernet-header.h>
@@ -72,14 +72,15 @@ auto udp_application::read_handler(ns3::Ptr<ns3::Socket> socket) -> void
     ns3::Address remote_address;
 
     while ((packet = socket->RecvFrom(remote_address))) {
-        auto content = packet_helper::to_string(packet);
-        log::debug("{:ip} has received a packet: \"{}\" size: {}", this->get_address(), content, content.size());
-        if (packet) {
-            auto msg_type = get_message_type(packet);
-            log::debug("{:ip} is processing [{}] message...", this->get_address(), msg_type);
-            auto dispatched = m_msg_handler.dispatch(msg_type, packet, remote_address);
-            NS_ASSERT_MSG(dispatched, "Invalid message type: " << msg_type);
+        if (log::level_debug_enabled) {
+            auto content = packet_helper::to_string(packet);
+            log::debug("{:ip} has received a packet: \"{}\" size: {}", this->get_address(), content, packet->GetSize());
         }
+
+        // 只解码一次，后续处理函数共用同一个 message
+        message msg(packet);
+        [[maybe_unused]] auto dispatched = this->dispatch(msg, packet, remote_address);
+        NS_ASSERT_MSG(dispatched, "Invalid message type: " << msg.get_value("msgtype"));
     }
 }
 
@@ -104,12 +105,28 @@ auto udp_application::get_port() -> u_int16_t const
 
 auto udp_application::set_request_handler(std::string_view msg_type, callback_type callback) -> void
 {
-    m_msg_handler.add_handler(msg_type, callback);
+    m_msg_handler.add_handler(msg_type,
+        [callback](message&, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) {
+            callback(packet, address);
+        });
+}
+
+auto udp_application::set_request_handler(std::string_view msg_type, message_callback_type callback) -> void
+{
+    m_msg_handler.add_handler(msg_type, std::move(callback));
 }
 
 auto udp_application::dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void
 {
-    m_msg_handler.dispatch(msg_type.data(), packet, address);
+    message msg(packet);
+    m_msg_handler.dispatch(msg_type, msg, packet, address);
+}
+
+auto udp_application::dispatch(message& msg, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> bool
+{
+    auto msg_type = msg.get_value("msgtype");
+    log::debug("{:ip} is processing [{}] message...", this->get_address(), msg_type);
+    return m_msg_handler.dispatch(msg_type, msg, packet, address);
 }
 
 auto udp_application::StartApplication() -> void
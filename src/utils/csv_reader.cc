@@ -0,0 +1,237 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/utils/csv_reader.h>
+#include <algorithm>
+#include <cstring>
+#include <ranges>
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <fstream>
+    #include <sstream>
+#endif
+
+
+namespace okec
+{
+
+namespace {
+
+// 去掉行尾的 '\r'
+auto trim_cr(std::string_view line) -> std::string_view {
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    return line;
+}
+
+} // namespace
+
+
+csv_reader::csv_reader(std::string_view file, char delimiter, bool has_header)
+    : delimiter_{delimiter}
+{
+#ifdef __linux__
+    int fd = ::open(std::string(file).c_str(), O_RDONLY);
+    if (fd == -1)
+        return;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+            size_ = st.st_size;
+        }
+    } else if (st.st_size == 0) {
+        data_ = "";
+    }
+    ::close(fd);
+#else
+    std::ifstream in(std::string(file), std::ios::binary);
+    if (!in.is_open())
+        return;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    buffer_ = std::move(ss).str();
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    if (!data_)
+        return;
+
+    body_ = data_;
+    if (has_header && size_ > 0) {
+        const char* end = data_ + size_;
+        const char* eol = static_cast<const char*>(std::memchr(data_, '\n', size_));
+        std::string_view line(data_, (eol ? eol : end) - data_);
+        body_ = eol ? eol + 1 : end;
+
+        std::vector<std::string_view> fields;
+        split(trim_cr(line), fields);
+        header_.assign(fields.begin(), fields.end());
+    }
+}
+
+csv_reader::csv_reader(csv_reader&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+csv_reader& csv_reader::operator=(csv_reader&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        bool owned = other.data_ == other.buffer_.data();
+        auto offset = other.body_ - other.data_;
+        buffer_ = std::move(other.buffer_);
+        data_ = owned ? buffer_.data() : other.data_;
+        size_ = other.size_;
+        body_ = other.data_ ? data_ + offset : nullptr;
+        delimiter_ = other.delimiter_;
+        header_ = std::move(other.header_);
+        predicates_ = std::move(other.predicates_);
+        other.data_ = other.body_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+csv_reader::~csv_reader()
+{
+    close();
+}
+
+auto csv_reader::close() noexcept -> void
+{
+#ifdef __linux__
+    if (data_ && size_ > 0)
+        ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = body_ = nullptr;
+    size_ = 0;
+}
+
+auto csv_reader::is_open() const noexcept -> bool
+{
+    return data_ != nullptr;
+}
+
+auto csv_reader::header() const -> const std::vector<std::string>&
+{
+    return header_;
+}
+
+auto csv_reader::column(std::string_view name) const -> std::optional<std::size_t>
+{
+    auto it = std::ranges::find(header_, name);
+    if (it == header_.end())
+        return std::nullopt;
+    return std::distance(header_.begin(), it);
+}
+
+auto csv_reader::index_of(std::string_view column) const -> std::size_t
+{
+    return this->column(column).value_or(static_cast<std::size_t>(-1));
+}
+
+auto csv_reader::where(predicate_type pred) -> csv_reader&
+{
+    predicates_.push_back(std::move(pred));
+    return *this;
+}
+
+auto csv_reader::where(std::size_t column, std::string_view value) -> csv_reader&
+{
+    return where([column, value = std::string(value)](const row& r) {
+        return column < r.size() && r[column] == value;
+    });
+}
+
+auto csv_reader::where(std::string_view column, std::string_view value) -> csv_reader&
+{
+    return where(index_of(column), value);
+}
+
+auto csv_reader::begin() const -> iterator
+{
+    return iterator(is_open() ? this : nullptr);
+}
+
+auto csv_reader::split(std::string_view line, std::vector<std::string_view>& fields) const -> void
+{
+    fields.clear();
+    std::size_t pos = 0;
+    for (;;) {
+        if (pos < line.size() && line[pos] == '"') {
+            // 引号字段，内容中的分隔符不拆分；"" 不做反转义
+            auto close = line.find('"', pos + 1);
+            if (close == std::string_view::npos) {
+                fields.push_back(line.substr(pos + 1));
+                return;
+            }
+            fields.push_back(line.substr(pos + 1, close - pos - 1));
+            auto next = line.find(delimiter_, close + 1);
+            if (next == std::string_view::npos)
+                return;
+            pos = next + 1;
+        } else {
+            auto next = line.find(delimiter_, pos);
+            if (next == std::string_view::npos) {
+                fields.push_back(line.substr(pos));
+                return;
+            }
+            fields.push_back(line.substr(pos, next - pos));
+            pos = next + 1;
+        }
+    }
+}
+
+
+csv_reader::iterator::iterator(const csv_reader* reader)
+    : reader_{reader}
+{
+    if (reader_) {
+        pos_ = reader_->body_;
+        advance();
+    }
+}
+
+auto csv_reader::iterator::operator++() -> iterator&
+{
+    advance();
+    return *this;
+}
+
+auto csv_reader::iterator::advance() -> void
+{
+    const char* end = reader_->data_ + reader_->size_;
+    while (pos_ < end) {
+        const char* eol = static_cast<const char*>(std::memchr(pos_, '\n', end - pos_));
+        std::string_view line = trim_cr(std::string_view(pos_, (eol ? eol : end) - pos_));
+        pos_ = eol ? eol + 1 : end;
+        if (line.empty())
+            continue;
+
+        reader_->split(line, row_.fields_);
+        row_.line_ = line;
+        if (std::ranges::all_of(reader_->predicates_, [this](const auto& pred) { return pred(row_); }))
+            return;
+    }
+
+    reader_ = nullptr;
+}
+
+} // namespace okec
@@ -11,33 +11,78 @@
 #include <okec/common/response.h>
 #include <okec/common/task.h>
 #include <okec/utils/packet_helper.h>
+#include <algorithm>
 
 
 namespace okec {
 namespace packet_helper {
 
+namespace {
+
+// There is only one ns3 simulator per process, so the format lives here.
+wire::format current_format = wire::format::binary;
+
+auto copy_data(ns3::Ptr<ns3::Packet> packet) -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> buffer(packet->GetSize());
+    packet->CopyData(buffer.data(), buffer.size());
+    return buffer;
+}
+
+} // namespace
+
+
+auto set_wire_format(wire::format fmt) -> void
+{
+    current_format = fmt;
+}
+
+auto get_wire_format() -> wire::format
+{
+    return current_format;
+}
 
 auto make_packet(std::string_view sv) -> ns3::Ptr<ns3::Packet>
 {
     return ns3::Create<ns3::Packet>((uint8_t*)sv.data(), sv.length() + 1);
 }
 
+auto to_packet(const json& j) -> ns3::Ptr<ns3::Packet>
+{
+    if (current_format == wire::format::json)
+        return make_packet(j.dump());
+
+    auto buffer = wire::encode(j);
+    return ns3::Create<ns3::Packet>(buffer.data(), buffer.size());
+}
+
+auto packet_size(const json& j) -> std::size_t
+{
+    // json text is sent with its trailing '\0'
+    return current_format == wire::format::json
+        ? j.dump().size() + 1
+        : wire::encoded_size(j);
+}
+
 auto to_string(ns3::Ptr<ns3::Packet> packet) -> std::string
 {
-    auto size = packet->GetSize();
-    auto buffer = new uint8_t[size];
-    packet->CopyData(buffer, size);
-    auto data = std::string(buffer, buffer + size);
-    delete[] buffer;
-    
-    return data;
+    auto buffer = copy_data(packet);
+    if (wire::is_binary(buffer.data(), buffer.size()))
+        return wire::decode(buffer.data(), buffer.size()).dump();
+
+    return std::string(buffer.begin(), buffer.end());
 }
 
 auto to_json(ns3::Ptr<ns3::Packet> packet) -> json
 {
-    json j;
-    auto data = to_string(packet);
-    return j.accept(data) ? j.parse(data) : j;
+    auto buffer = copy_data(packet);
+    if (wire::is_binary(buffer.data(), buffer.size()))
+        return wire::decode(buffer.data(), buffer.size());
+
+    // strip the trailing '\0' and parse once, without exceptions
+    auto last = std::find(buffer.begin(), buffer.end(), uint8_t{0});
+    json j = json::parse(buffer.begin(), last, nullptr, false);
+    return j.is_discarded() ? json{} : j;
 }
 
 
@@ -9,34 +9,28 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/utils/read_csv.h>
-#include <fstream>
-#include <ranges>
+#include <okec/utils/csv_reader.h>
 
 
 auto okec::read_csv(std::string_view file, std::string_view type, std::string_view delimiter)
     -> std::optional<dataset_sequence_type>
 {
-    std::ifstream data_file(file.data());
-    if (!data_file.is_open()) {
+    csv_reader reader(file, delimiter.empty() ? ',' : delimiter.front());
+    if (!reader.is_open()) {
         return {};
     }
 
-    std::string line;
-    std::getline(data_file, line); // skip the title
+    if (!type.empty()) {
+        reader.where(2, type); // the third column holds the type
+    }
+
     dataset_sequence_type result;
-    while (std::getline(data_file, line)) {
-        auto tokens = line
-                    | std::views::split(delimiter)
-                    | std::views::transform([](auto&& token) {
-                        return std::string_view(&*token.begin(), std::ranges::distance(token));
-                    });
-        
-        auto it = std::ranges::begin(tokens);
-        std::ranges::advance(it, 2);
-        if (type.empty() || *it == type) {
-			// save all records or filtered records.
-			result.push_back(dataset_sequence_type::value_type(tokens.begin(), tokens.end()));
-		}
+    for (const auto& row : reader) {
+        auto& record = result.emplace_back();
+        record.reserve(row.size());
+        for (std::size_t i = 0; i < row.size(); ++i) {
+            record.emplace_back(row[i]);
+        }
     }
 
     return result;
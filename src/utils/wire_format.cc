@@ -0,0 +1,413 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/utils/wire_format.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+
+namespace okec {
+namespace wire {
+
+namespace {
+
+enum tag : std::uint8_t {
+    tag_null = 0x00,
+    tag_false,
+    tag_true,
+    tag_integer,
+    tag_double,
+    tag_string,
+    tag_array,
+    tag_object,
+    tag_numeric_integer,
+    tag_numeric_float,
+    tag_numeric_double,
+};
+
+inline constexpr std::uint8_t literal_key = 0xFF;
+
+// Keys used by the built-in messages, tasks and resources. Ids are part of
+// the wire format: only ever append to this table.
+inline constexpr std::array<std::string_view, 43> well_known_keys {
+    "msgtype", "content", "task", "items", "header", "body",
+    "task_id", "group", "cpu", "deadline", "size", "status",
+    "arrival_time", "transmission_delay", "resource", "device_type",
+    "ip", "port", "pos_x", "pos_y", "pos_z", "cpu_supply",
+    "uncertain_cpu_supply", "response", "device_address", "finished",
+    "processing_time", "processing_delay", "wait_time", "time_consuming",
+    "send_time", "power_consumption", "type", "device_cache",
+    "memory", "bandwidth", "address", "value",
+    "version", "max_cpu", "total_cpu", "forwarded", "zone",
+};
+
+auto key_id(std::string_view key) -> int
+{
+    auto it = std::ranges::find(well_known_keys, key);
+    return it == well_known_keys.end() ? -1 : static_cast<int>(it - well_known_keys.begin());
+}
+
+auto zigzag(std::int64_t v) -> std::uint64_t
+{
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+auto unzigzag(std::uint64_t v) -> std::int64_t
+{
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+auto varint_size(std::uint64_t v) -> std::size_t
+{
+    std::size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+// How a string attribute is going to be stored.
+struct numeric_string {
+    tag kind = tag_string;
+    std::int64_t i{};
+    double d{};
+};
+
+auto classify(std::string_view sv) -> numeric_string
+{
+    numeric_string result{};
+    if (sv.empty() || sv.size() > 24)
+        return result;
+
+    const char* first = sv.data();
+    const char* last = sv.data() + sv.size();
+    char buf[32];
+
+    std::int64_t i{};
+    if (auto parsed = std::from_chars(first, last, i); parsed.ptr == last) {
+        if (parsed.ec != std::errc{})
+            return result;
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), i);
+        if (ec == std::errc{} && std::string_view(buf, end) == sv) {
+            result.kind = tag_numeric_integer;
+            result.i = i;
+        }
+        return result;
+    }
+
+    double d{};
+    if (auto parsed = std::from_chars(first, last, d); parsed.ptr == last) {
+        if (parsed.ec != std::errc{})
+            return result;
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), d);
+        if (ec == std::errc{} && std::string_view(buf, end) == sv) {
+            result.kind = static_cast<double>(static_cast<float>(d)) == d
+                ? tag_numeric_float : tag_numeric_double;
+            result.d = d;
+        }
+    }
+
+    return result;
+}
+
+auto string_size(std::string_view sv) -> std::size_t
+{
+    return varint_size(sv.size()) + sv.size();
+}
+
+auto value_size(const json& j) -> std::size_t
+{
+    switch (j.type()) {
+    case json::value_t::null:
+    case json::value_t::boolean:
+    case json::value_t::discarded:
+        return 1;
+    case json::value_t::number_integer:
+        return 1 + varint_size(zigzag(j.get<std::int64_t>()));
+    case json::value_t::number_unsigned:
+        if (auto u = j.get<std::uint64_t>(); u <= INT64_MAX)
+            return 1 + varint_size(zigzag(static_cast<std::int64_t>(u)));
+        return 1 + 8;
+    case json::value_t::number_float:
+        return 1 + 8;
+    case json::value_t::string: {
+        auto& s = j.get_ref<const json::string_t&>();
+        switch (auto n = classify(s); n.kind) {
+        case tag_numeric_integer: return 1 + varint_size(zigzag(n.i));
+        case tag_numeric_float:   return 1 + 4;
+        case tag_numeric_double:  return 1 + 8;
+        default:                  return 1 + string_size(s);
+        }
+    }
+    case json::value_t::array: {
+        std::size_t n = 1 + varint_size(j.size());
+        for (const auto& v : j)
+            n += value_size(v);
+        return n;
+    }
+    case json::value_t::object: {
+        std::size_t n = 1 + varint_size(j.size());
+        for (const auto& [key, v] : j.items())
+            n += (key_id(key) < 0 ? 1 + string_size(key) : 1) + value_size(v);
+        return n;
+    }
+    case json::value_t::binary:
+        break;
+    }
+
+    throw std::invalid_argument("okec::wire: binary json values are not supported");
+}
+
+
+class writer {
+public:
+    explicit writer(std::size_t reserve) { buf_.reserve(reserve); }
+
+    auto byte(std::uint8_t b) -> void { buf_.push_back(b); }
+
+    auto varint(std::uint64_t v) -> void {
+        while (v >= 0x80) {
+            buf_.push_back(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        buf_.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    template <typename T>
+    auto raw(T v) -> void {
+        static_assert(std::endian::native == std::endian::little);
+        auto p = reinterpret_cast<const std::uint8_t*>(&v);
+        buf_.insert(buf_.end(), p, p + sizeof(T));
+    }
+
+    auto string(std::string_view sv) -> void {
+        varint(sv.size());
+        buf_.insert(buf_.end(), sv.begin(), sv.end());
+    }
+
+    auto key(std::string_view sv) -> void {
+        if (auto id = key_id(sv); id >= 0) {
+            byte(static_cast<std::uint8_t>(id));
+        } else {
+            byte(literal_key);
+            string(sv);
+        }
+    }
+
+    auto value(const json& j) -> void {
+        switch (j.type()) {
+        case json::value_t::null:
+        case json::value_t::discarded:
+            byte(tag_null);
+            break;
+        case json::value_t::boolean:
+            byte(j.get<bool>() ? tag_true : tag_false);
+            break;
+        case json::value_t::number_integer:
+            byte(tag_integer);
+            varint(zigzag(j.get<std::int64_t>()));
+            break;
+        case json::value_t::number_unsigned:
+            if (auto u = j.get<std::uint64_t>(); u <= INT64_MAX) {
+                byte(tag_integer);
+                varint(zigzag(static_cast<std::int64_t>(u)));
+            } else {
+                byte(tag_double);
+                raw(static_cast<double>(u));
+            }
+            break;
+        case json::value_t::number_float:
+            byte(tag_double);
+            raw(j.get<double>());
+            break;
+        case json::value_t::string: {
+            auto& s = j.get_ref<const json::string_t&>();
+            switch (auto n = classify(s); n.kind) {
+            case tag_numeric_integer:
+                byte(tag_numeric_integer);
+                varint(zigzag(n.i));
+                break;
+            case tag_numeric_float:
+                byte(tag_numeric_float);
+                raw(static_cast<float>(n.d));
+                break;
+            case tag_numeric_double:
+                byte(tag_numeric_double);
+                raw(n.d);
+                break;
+            default:
+                byte(tag_string);
+                string(s);
+            }
+            break;
+        }
+        case json::value_t::array:
+            byte(tag_array);
+            varint(j.size());
+            for (const auto& v : j)
+                value(v);
+            break;
+        case json::value_t::object:
+            byte(tag_object);
+            varint(j.size());
+            for (const auto& [k, v] : j.items()) {
+                key(k);
+                value(v);
+            }
+            break;
+        case json::value_t::binary:
+            throw std::invalid_argument("okec::wire: binary json values are not supported");
+        }
+    }
+
+    auto release() -> std::vector<std::uint8_t> { return std::move(buf_); }
+
+private:
+    std::vector<std::uint8_t> buf_;
+};
+
+
+class reader {
+public:
+    reader(const std::uint8_t* data, std::size_t size)
+        : p_{data}, end_{data + size} {}
+
+    auto byte() -> std::uint8_t {
+        need(1);
+        return *p_++;
+    }
+
+    auto varint() -> std::uint64_t {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto b = byte();
+            v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return v;
+        }
+        throw std::out_of_range("okec::wire: malformed varint");
+    }
+
+    template <typename T>
+    auto raw() -> T {
+        need(sizeof(T));
+        T v;
+        std::memcpy(&v, p_, sizeof(T));
+        p_ += sizeof(T);
+        return v;
+    }
+
+    auto string() -> std::string {
+        auto n = varint();
+        need(n);
+        std::string s(reinterpret_cast<const char*>(p_), n);
+        p_ += n;
+        return s;
+    }
+
+    auto key() -> std::string {
+        auto id = byte();
+        if (id == literal_key)
+            return string();
+        if (id >= well_known_keys.size())
+            throw std::out_of_range("okec::wire: unknown key id");
+        return std::string(well_known_keys[id]);
+    }
+
+    auto value() -> json {
+        switch (byte()) {
+        case tag_null:    return nullptr;
+        case tag_false:   return false;
+        case tag_true:    return true;
+        case tag_integer: return unzigzag(varint());
+        case tag_double:  return raw<double>();
+        case tag_string:  return string();
+        case tag_numeric_integer: return std::to_string(unzigzag(varint()));
+        case tag_numeric_float:   return format_number(static_cast<double>(raw<float>()));
+        case tag_numeric_double:  return format_number(raw<double>());
+        case tag_array: {
+            json j = json::array();
+            for (auto n = varint(); n > 0; --n)
+                j.push_back(value());
+            return j;
+        }
+        case tag_object: {
+            json j = json::object();
+            for (auto n = varint(); n > 0; --n) {
+                auto k = key();
+                j[std::move(k)] = value();
+            }
+            return j;
+        }
+        default:
+            throw std::out_of_range("okec::wire: unknown tag");
+        }
+    }
+
+private:
+    static auto format_number(double d) -> std::string {
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), d);
+        return std::string(buf, end);
+    }
+
+    auto need(std::size_t n) -> void {
+        if (static_cast<std::size_t>(end_ - p_) < n)
+            throw std::out_of_range("okec::wire: truncated packet");
+    }
+
+    const std::uint8_t* p_;
+    const std::uint8_t* end_;
+};
+
+} // namespace
+
+
+auto encode(const json& j) -> std::vector<std::uint8_t>
+{
+    writer w(encoded_size(j));
+    w.byte(magic);
+    w.byte(version);
+    w.value(j);
+    return w.release();
+}
+
+auto decode(const std::uint8_t* data, std::size_t size) -> json
+{
+    if (!is_binary(data, size))
+        return json{};
+
+    try {
+        reader r(data + 2, size - 2);
+        return r.value();
+    } catch (const std::exception&) {
+        return json{};
+    }
+}
+
+auto encoded_size(const json& j) -> std::size_t
+{
+    return 2 + value_size(j);
+}
+
+auto is_binary(const std::uint8_t* data, std::size_t size) -> bool
+{
+    return size >= 2 && data[0] == magic && data[1] == version;
+}
+
+
+} // namespace wire
+} // namespace okec
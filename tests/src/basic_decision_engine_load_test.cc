@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/okec.hpp>
+#include "check.h"
+#include <numeric>
+
+
+// 设备拒绝任务后，在途计数要从原设备上撤下，重新分发时只记在新设备上
+int main()
+{
+    okec::log::set_level(okec::log::level::error);
+
+    okec::simulator sim(ns3::Seconds(5));
+    okec::base_station_container bs(sim, 1);
+    okec::edge_device_container edge_servers(sim, 2);
+    okec::client_device_container user_devices(sim, 1);
+    bs.connect_device(edge_servers);
+
+    okec::multiple_and_single_LAN_WLAN_network_model model;
+    okec::network_initializer(model, user_devices, bs.get(0));
+
+    okec::resource_container resources(edge_servers.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", "2.5");
+    });
+    edge_servers.install_resources(resources);
+
+    // 轮询：被拒绝后的重试一定落在另一台设备上
+    auto engine = std::make_shared<okec::round_robin_decision_engine>(&user_devices, &bs);
+    engine->initialize();
+
+    auto user = user_devices.get_device(0);
+    auto id = okec::task::unique_id();
+    okec::task t;
+    t.emplace_back({
+        { "task_id", id.to_string() },
+        { "group", "load" },
+        { "cpu", "1" },
+        { "from_ip", okec::format("{:ip}", user->get_address()) },
+        { "from_port", std::to_string(user->get_port()) }
+    });
+    user->response_cache().emplace_back({
+        { "task_id", id.to_string() },
+        { "group", "load" },
+        { "finished", "0" }
+    });
+
+    auto total_load = [&engine]() {
+        auto load = engine->load();
+        return std::accumulate(load.begin(), load.end(), std::size_t{});
+    };
+
+    okec::device_cache::index_type first = okec::device_cache::npos;
+    ns3::Simulator::Schedule(ns3::Seconds(1), [&]() {
+        bs.get(0)->task_sequence(t.elements().front());
+        engine->handle_next();
+        CHECK(total_load() == 1);
+
+        // 处理请求到达之前，被选中的设备的资源被占满
+        first = engine->load()[0] == 1 ? 0 : 1;
+        for (auto& es : edge_servers) {
+            if (es->get_address() == engine->cache().address(first) && es->get_port() == engine->cache().port(first))
+                es->get_resource()->subtract("cpu", 2.0);
+        }
+    });
+
+    // 重试已分发到另一台设备，仍在处理中
+    ns3::Simulator::Schedule(ns3::Seconds(1.2), [&]() {
+        CHECK(engine->stats().conflicts == 1);
+        CHECK(total_load() == 1);
+        CHECK(engine->load()[first] == 0);
+    });
+
+    sim.run();
+
+    CHECK(engine->stats().conflicts == 1);
+    CHECK(engine->stats().retries == 1);
+    CHECK(bs.get(0)->task_sequence().empty());
+    CHECK(total_load() == 0);
+
+    return okec_test_failures;
+}
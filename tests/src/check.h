@@ -0,0 +1,28 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TEST_CHECK_H_
+#define OKEC_TEST_CHECK_H_
+
+#include <cstdio>
+
+
+// 失败时打印位置并计数，main 返回 okec_test_failures 作为退出码
+inline int okec_test_failures = 0;
+
+#define CHECK(expr)                                                                 \
+    do {                                                                            \
+        if (!(expr)) {                                                              \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+            ++okec_test_failures;                                                   \
+        }                                                                           \
+    } while (0)
+
+#endif // OKEC_TEST_CHECK_H_
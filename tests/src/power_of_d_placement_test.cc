@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/algorithms/placement_policies.hpp>
+#include "check.h"
+#include <limits>
+
+
+int main()
+{
+    okec::device_cache cache;
+    auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    auto unknown = cache.emplace("es", ns3::Ipv4Address("10.1.1.1"), 8860, ns3::Vector(0, 0, 0));
+    auto known = cache.emplace("es", ns3::Ipv4Address("10.1.1.2"), 8861, ns3::Vector(0, 0, 0));
+    cache.set(unknown, "cpu", nan); // 尚未上报资源
+    cache.set(known, "cpu", 2.0);
+
+    auto make_view = [&]() {
+        return okec::placement_view{
+            .cache = cache,
+            .key = "cpu",
+            .supply = cache.column("cpu")
+        };
+    };
+
+    // 抽到 NaN 的设备也不能被选中
+    okec::power_of_d_placement placement(2);
+    for (int n = 0; n < 100; ++n) {
+        auto index = placement(1.0, make_view());
+        CHECK(index != unknown);
+    }
+
+    // 只剩 NaN 的设备时放置失败
+    cache.set(known, "cpu", nan);
+    CHECK(placement(1.0, make_view()) == okec::device_cache::npos);
+
+    okec::power_of_d_placement local_placement(2, true);
+    auto view = make_view();
+    view.zone = 0;
+    CHECK(local_placement(1.0, view) == okec::device_cache::npos);
+
+    return okec_test_failures;
+}
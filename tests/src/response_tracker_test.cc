@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/response.h>
+#include "check.h"
+
+
+int main()
+{
+    okec::response_tracker responses;
+    auto id = okec::task_id::generate().to_string();
+
+    auto send = [&](std::string_view group) {
+        return responses.emplace_back({
+            { "task_id", id },
+            { "group", group },
+            { "finished", "0" }
+        });
+    };
+
+    // 同一个任务发送两次，只算一个未完成的任务
+    CHECK(send("g"));
+    CHECK(send("g"));
+    CHECK(responses.size() == 1);
+    CHECK(responses.outstanding("g") == 1);
+
+    CHECK(responses.finish(okec::task_id::of(id), "Y"));
+    CHECK(responses.outstanding("g") == 0);
+
+    // 完成后重发，重新变为未完成
+    CHECK(send("g"));
+    CHECK(responses.outstanding("g") == 1);
+    CHECK(responses.finish(okec::task_id::of(id), "N"));
+    CHECK(responses.outstanding("g") == 0);
+
+    // 同一个 id 不能登记到另一个组
+    CHECK(!send("other"));
+    CHECK(!responses.contains("other"));
+
+    auto taken = responses.take("g");
+    CHECK(taken.size() == 1);
+    CHECK(responses.empty());
+
+    return okec_test_failures;
+}